@@ -30,6 +30,7 @@
 #include "models/serverconfig.h"
 #include "models/connectionsmanager.h"
 #include "models/key-models/keyfactory.h"
+#include "models/key-models/rowcache.h"
 #include "modules/bulk-operations/bulkoperationsmanager.h"
 #include "modules/common/sortfilterproxymodel.h"
 #include "modules/console/autocompletemodel.h"
@@ -273,6 +274,12 @@ void Application::initModels() {
      * 所以多个线程同时修改 QSharedPointer 指向的数据时还要应该考虑加锁。
     */
 
+    // 值编辑器行缓存的内存上限(MB)
+    QSettings settings;
+    qulonglong modelCacheLimit = settings.value("app/valueCacheModelLimit", RowCacheBudget::DEFAULT_MODEL_LIMIT / 1024 / 1024).toULongLong();
+    qulonglong globalCacheLimit = settings.value("app/valueCacheGlobalLimit", RowCacheBudget::DEFAULT_GLOBAL_LIMIT / 1024 / 1024).toULongLong();
+    RowCacheBudget::setLimits(modelCacheLimit * 1024 * 1024, globalCacheLimit * 1024 * 1024);
+
     m_keyFactory = QSharedPointer<KeyFactory>(new KeyFactory());
     m_keyValues = QSharedPointer<ValueEditor::TabsModel>(new ValueEditor::TabsModel(m_keyFactory.staticCast<ValueEditor::AbstractKeyFactory>(), m_events));
     // 设置信号槽 ,函数4个参数：发射信号的对象，发射的信号，接受信号的对象，要执行的槽；
@@ -26,6 +26,10 @@ signals:
 
     void closeDbKeys(QSharedPointer<RedisClient::Connection> connection, int dbIndex, const QRegExp &filter = QRegExp("*", Qt::CaseSensitive, QRegExp::Wildcard));
 
+    // Keys loading paused at keys_loading_limit, loadMoreKeys continues it
+    void keysLoadingPaused(QSharedPointer<RedisClient::Connection> connection, int dbIndex);
+    void loadMoreKeys(QSharedPointer<RedisClient::Connection> connection, int dbIndex);
+
 
     void requestBulkOperation(QSharedPointer<RedisClient::Connection> connection, int dbIndex, BulkOperations::Manager::Operation op, QRegExp keyPattern,  BulkOperations::AbstractOperation::OperationCallback callback);
 
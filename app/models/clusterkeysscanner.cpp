@@ -0,0 +1,78 @@
+#include "clusterkeysscanner.h"
+#include <QCoreApplication>
+#include <QPointer>
+
+
+ClusterKeysScanner::ClusterKeysScanner(QSharedPointer<RedisClient::Connection> connection, ConnectionPool &pool, const QByteArray &pattern, int maxConcurrency)
+    : QObject(), m_connection(connection), m_pool(pool), m_pattern(pattern), m_maxConcurrency(qMax(1, maxConcurrency)), m_runningScanners(0) {}
+
+void ClusterKeysScanner::start(KeyScanner::BatchCallback callback) {
+    m_callback = callback;
+    QPointer<ClusterKeysScanner> self(this);
+
+    m_connection->getMasterNodes([this, self](RedisClient::Connection::HostList nodes, const QString &err) {
+        if (!self || !m_callback) { return; }
+
+        if (!err.isEmpty() || nodes.isEmpty()) {
+            auto callback = m_callback;
+            m_callback = KeyScanner::BatchCallback();
+            return callback(RedisClient::Connection::RawKeysList(),
+                            err.isEmpty() ? QCoreApplication::translate("RDM", "Cannot find cluster master nodes") : err, true);
+        }
+
+        m_pendingNodes = nodes;
+        scanNextNodes();
+    });
+}
+
+void ClusterKeysScanner::cancel() {
+    m_callback = KeyScanner::BatchCallback();
+    m_pendingNodes.clear();
+
+    for (auto scanner : m_scanners) {
+        scanner->cancel();
+    }
+    m_scanners.clear();
+}
+
+void ClusterKeysScanner::scanNextNodes() {
+    while (m_runningScanners < m_maxConcurrency && !m_pendingNodes.isEmpty()) {
+        auto connection = m_pool.nodeConnection(m_pendingNodes.takeFirst());
+        if (!connection) { continue; }
+
+        auto scanner = QSharedPointer<KeyScanner>(new KeyScanner(connection, m_pattern), &QObject::deleteLater);
+        scanner->setTypeFilter(m_type);
+        m_scanners.append(scanner);
+        m_runningScanners++;
+
+        scanner->start([this](const RedisClient::Connection::RawKeysList &keys, const QString &err, bool finished) {
+            onBatch(keys, err, finished);
+        });
+    }
+}
+
+void ClusterKeysScanner::onBatch(const RedisClient::Connection::RawKeysList &keys, const QString &err, bool finished) {
+    if (!m_callback) { return; }
+
+    if (!err.isEmpty()) {
+        m_lastError = err;
+    }
+
+    if (finished) {
+        m_runningScanners--;
+        scanNextNodes();
+    }
+
+    bool allNodesScanned = m_runningScanners == 0 && m_pendingNodes.isEmpty();
+    if (!allNodesScanned) {
+        if (!keys.isEmpty()) {
+            m_callback(keys, QString(), false);
+        }
+        return;
+    }
+
+    auto callback = m_callback;
+    m_callback = KeyScanner::BatchCallback();
+    m_scanners.clear();
+    callback(keys, m_lastError, true);
+}
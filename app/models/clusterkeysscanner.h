@@ -0,0 +1,39 @@
+#pragma once
+#include <QList>
+#include <QObject>
+#include <QSharedPointer>
+#include "connectionpool.h"
+#include "keyscanner.h"
+
+
+// Scans keys on all cluster master nodes concurrently.
+// Every node is scanned on its own pooled connection, at most maxConcurrency
+// nodes at a time. Batches from all nodes are delivered as they arrive and
+// callback is called with finished = true once every node is scanned.
+class ClusterKeysScanner : public QObject {
+    Q_OBJECT
+
+public:
+    ClusterKeysScanner(QSharedPointer<RedisClient::Connection> connection, ConnectionPool &pool, const QByteArray &pattern, int maxConcurrency);
+
+    void setTypeFilter(const QByteArray &type) { m_type = type; }
+
+    void start(KeyScanner::BatchCallback callback);
+    void cancel();
+
+private:
+    void scanNextNodes();
+    void onBatch(const RedisClient::Connection::RawKeysList &keys, const QString &err, bool finished);
+
+private:
+    QSharedPointer<RedisClient::Connection> m_connection;
+    ConnectionPool &m_pool;
+    QByteArray m_pattern;
+    QByteArray m_type;
+    int m_maxConcurrency;
+    RedisClient::Connection::HostList m_pendingNodes;
+    QList<QSharedPointer<KeyScanner>> m_scanners;
+    int m_runningScanners;
+    QString m_lastError;
+    KeyScanner::BatchCallback m_callback;
+};
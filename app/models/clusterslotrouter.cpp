@@ -0,0 +1,199 @@
+#include "clusterslotrouter.h"
+#include <QCoreApplication>
+#include <QPointer>
+#include <QtConcurrent>
+#include "app/models/hashslot.h"
+
+
+ClusterSlotRouter::ClusterSlotRouter(RedisClient::Connection *master)
+    : QObject(master), m_loaded(false) {
+    m_slots.fill(-1);
+    connect(master, &RedisClient::Connection::connected, this, &ClusterSlotRouter::refresh);
+    refresh();
+}
+
+ClusterSlotRouter *ClusterSlotRouter::of(RedisClient::Connection *master) {
+    if (!master) { return nullptr; }
+    return master->findChild<ClusterSlotRouter *>(QString(), Qt::FindDirectChildrenOnly);
+}
+
+bool ClusterSlotRouter::isActive() const {
+    auto connection = master();
+    return m_loaded && connection && connection->mode() == RedisClient::Connection::Mode::Cluster;
+}
+
+RedisClient::Connection::Host ClusterSlotRouter::nodeForSlot(quint16 slot) const {
+    qint16 index = m_slots.at(slot % SLOTS_COUNT);
+    return index < 0 ? RedisClient::Connection::Host() : m_nodes.at(index);
+}
+
+QSharedPointer<RedisClient::Connection> ClusterSlotRouter::connectionFor(const QByteArray &key) {
+    auto node = isActive() ? nodeForSlot(HashSlot::keySlot(key)) : RedisClient::Connection::Host();
+    if (node.first.isEmpty()) {
+        return QSharedPointer<RedisClient::Connection>();
+    }
+    return nodeConnection(node);
+}
+
+QSharedPointer<RedisClient::Connection> ClusterSlotRouter::nodeConnection(const RedisClient::Connection::Host &node) {
+    auto connection = m_connections.value(node);
+    if (connection || !master()) { return connection; }
+
+    RedisClient::ConnectionConfig config = master()->getConfig();
+    if (!config.overrideClusterHost()) {
+        config.setHost(node.first);
+    }
+    config.setPort(node.second);
+
+    connection = master()->clone(false);
+    connection->setConnectionConfig(config);
+    m_connections.insert(node, connection);
+
+    // NOTE: node connection follows redirects on its own by reconnecting,
+    // which means that slot table is stale
+    connect(connection.data(), &RedisClient::Connection::reconnectTo, this, &ClusterSlotRouter::refresh);
+    return connection;
+}
+
+void ClusterSlotRouter::closeConnections() {
+    auto connections = m_connections.values();
+    m_connections.clear();
+    if (connections.isEmpty()) { return; }
+
+    QtConcurrent::run([connections]() {
+        for (auto connection : connections) {
+            connection->disconnect();
+        }
+    });
+}
+
+void ClusterSlotRouter::execute(const QList<QByteArray> &cmd, const QByteArray &key, QObject *owner,
+                                std::function<void(const RedisClient::Response &)> callback,
+                                std::function<void(const QString &)> errback, int redirects) {
+    auto node = connectionFor(key);
+    RedisClient::Connection *connection = node ? node.data() : master();
+    if (!connection) { return errback(QCoreApplication::translate("RDM", "Connection is closed")); }
+
+    QPointer<ClusterSlotRouter> self(this);
+
+    // NOTE: Connection::cmd() reports error replies as plain strings, so redirects
+    // are detected on raw responses
+    auto onResponse = [self, cmd, key, owner, callback, errback, redirects](RedisClient::Response r, QString err) {
+        if (!err.isEmpty()) { return errback(err); }
+        if (!r.isErrorMessage()) { return callback(r); }
+
+        Redirect redirect;
+        if (!self || redirects >= MAX_REDIRECTS || !parseRedirect(r.value().toByteArray(), redirect)) {
+            return errback(r.value().toString());
+        }
+
+        if (redirect.moved) {
+            self->updateSlot(redirect.slot, redirect.node);
+            return self->execute(cmd, key, owner, callback, errback, redirects + 1);
+        }
+
+        // ASK: slot is being migrated, only this command goes to the target node
+        auto target = self->nodeConnection(redirect.node);
+        target->cmd({"ASKING"}, owner, -1, [](const RedisClient::Response &) {}, [](const QString &) {});
+        target->cmd(cmd, owner, -1, callback, errback);
+    };
+
+    try {
+        connection->command(cmd, owner, onResponse, -1);
+    } catch (const RedisClient::Connection::Exception &e) {
+        errback(QString(e.what()));
+    }
+}
+
+void ClusterSlotRouter::executePerKey(const QList<QByteArray> &command, const QList<QByteArray> &keys, int db,
+                                      QObject *owner, RepliesCallback callback) {
+    struct State {
+        QVariantList replies;
+        int pending = 0;
+        QString err;
+    };
+
+    bool cluster = isActive();
+    auto state = QSharedPointer<State>::create();
+    state->pending = keys.size();
+    state->replies.reserve(keys.size());
+    for (int i = 0; i < keys.size(); ++i) { state->replies.append(QVariant()); }
+
+    if (keys.isEmpty()) { return callback(state->replies, QString()); }
+
+    auto finish = [state, callback](int index, const QVariant &reply, const QString &err) {
+        if (err.isEmpty()) {
+            state->replies[index] = reply;
+        } else if (state->err.isEmpty()) {
+            state->err = err;
+        }
+        if (--state->pending == 0) { callback(state->replies, state->err); }
+    };
+
+    // NOTE: every key gets its own command, so error replies are recognized by
+    // reply type and never taken for values. Commands of one node are queued on
+    // its connection, nodes work in parallel.
+    for (int i = 0; i < keys.size(); ++i) {
+        QList<QByteArray> cmd = QList<QByteArray>(command) << keys.at(i);
+        auto onResponse = [finish, i](const RedisClient::Response &r) { finish(i, r.value(), QString()); };
+        auto onError = [finish, i](const QString &err) { finish(i, QVariant(), err); };
+
+        if (cluster) {
+            execute(cmd, keys.at(i), owner, onResponse, onError);
+        } else if (master()) {
+            master()->cmd(cmd, owner, db, onResponse, onError);
+        } else {
+            onError(QCoreApplication::translate("RDM", "Connection is closed"));
+        }
+    }
+}
+
+void ClusterSlotRouter::updateSlot(quint16 slot, const RedisClient::Connection::Host &node) {
+    m_slots[slot % SLOTS_COUNT] = static_cast<qint16>(nodeIndex(node));
+}
+
+void ClusterSlotRouter::refresh() {
+    auto connection = master();
+    if (!connection || connection->mode() != RedisClient::Connection::Mode::Cluster) { return; }
+
+    QPointer<ClusterSlotRouter> self(this);
+    connection->getClusterSlots([self](RedisClient::Connection::ClusterSlots slots, const QString &err) {
+        if (!self || !err.isEmpty()) { return; }
+
+        for (auto i = slots.constBegin(); i != slots.constEnd(); ++i) {
+            qint16 index = static_cast<qint16>(self->nodeIndex(i.value()));
+            for (int slot = qMax(0, i.key().first); slot <= qMin(SLOTS_COUNT - 1, i.key().second); ++slot) {
+                self->m_slots[slot] = index;
+            }
+        }
+        self->m_loaded = true;
+    });
+}
+
+bool ClusterSlotRouter::parseRedirect(const QByteArray &error, Redirect &redirect) {
+    // MOVED 3999 127.0.0.1:6381
+    QList<QByteArray> parts = error.trimmed().split(' ');
+    if (parts.size() != 3 || (parts.at(0) != "MOVED" && parts.at(0) != "ASK")) { return false; }
+
+    int separator = parts.at(2).lastIndexOf(':');
+    if (separator <= 0) { return false; }
+
+    bool ok = false;
+    redirect.moved = parts.at(0) == "MOVED";
+    redirect.slot = parts.at(1).toUShort(&ok);
+    redirect.node = {QString::fromUtf8(parts.at(2).left(separator)), parts.at(2).mid(separator + 1).toInt()};
+    return ok && redirect.slot < SLOTS_COUNT;
+}
+
+int ClusterSlotRouter::nodeIndex(const RedisClient::Connection::Host &node) {
+    auto i = m_nodeIndexes.constFind(node);
+    if (i != m_nodeIndexes.constEnd()) { return i.value(); }
+
+    m_nodes.append(node);
+    m_nodeIndexes.insert(node, m_nodes.size() - 1);
+    return m_nodes.size() - 1;
+}
+
+RedisClient::Connection *ClusterSlotRouter::master() const {
+    return qobject_cast<RedisClient::Connection *>(parent());
+}
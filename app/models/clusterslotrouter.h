@@ -0,0 +1,80 @@
+#pragma once
+#include <QHash>
+#include <QObject>
+#include <QSharedPointer>
+#include <QVector>
+#include <array>
+#include <functional>
+#include "connection.h"
+#include "app/models/hashslot.h"
+
+
+// Hash slot table of a cluster connection.
+// Slot owners are kept in a flat 16384-entry table, so routing a key is a
+// single array lookup. MOVED replies update the table one slot at a time and
+// ASK replies are followed with ASKING without touching it. Node connections
+// are persistent, routed commands never wait for a reconnect.
+// Router is attached to the main connection as a child object and is idle
+// until that connection works in cluster mode.
+class ClusterSlotRouter : public QObject {
+    Q_OBJECT
+
+public:
+    static const int SLOTS_COUNT = HashSlot::SLOTS_COUNT;
+    static const int MAX_REDIRECTS = 5;
+
+    typedef std::function<void(const QVariantList &replies, const QString &err)> RepliesCallback;
+
+public:
+    explicit ClusterSlotRouter(RedisClient::Connection *master);
+
+    static ClusterSlotRouter *of(RedisClient::Connection *master);
+
+    bool isActive() const;
+
+    // Node which owns slot, empty host if slot owner is unknown
+    RedisClient::Connection::Host nodeForSlot(quint16 slot) const;
+
+    // Connection to node which owns key slot, null if the owner is unknown
+    QSharedPointer<RedisClient::Connection> connectionFor(const QByteArray &key);
+    QSharedPointer<RedisClient::Connection> nodeConnection(const RedisClient::Connection::Host &node);
+
+    // Runs command on node which owns key and follows MOVED/ASK redirects.
+    // Multi-key commands are not split by slot, all keys must share one slot
+    void execute(const QList<QByteArray> &cmd, const QByteArray &key, QObject *owner,
+                 std::function<void(const RedisClient::Response &)> callback,
+                 std::function<void(const QString &)> errback, int redirects = 0);
+
+    // Runs single-key command (e.g. MEMORY USAGE) for every key on the node
+    // which owns it, nodes are queried in parallel. Replies are in order of
+    // keys, keys with error reply have null reply and the first error is
+    // passed to callback.
+    void executePerKey(const QList<QByteArray> &command, const QList<QByteArray> &keys, int db,
+                       QObject *owner, RepliesCallback callback);
+
+    void updateSlot(quint16 slot, const RedisClient::Connection::Host &node);
+
+    // Closes node connections, they are reopened on demand
+    void closeConnections();
+
+public slots:
+    void refresh();
+
+private:
+    struct Redirect {
+        bool moved;
+        quint16 slot;
+        RedisClient::Connection::Host node;
+    };
+
+    static bool parseRedirect(const QByteArray &error, Redirect &redirect);
+    int nodeIndex(const RedisClient::Connection::Host &node);
+    RedisClient::Connection *master() const;
+
+private:
+    std::array<qint16, SLOTS_COUNT> m_slots;
+    QVector<RedisClient::Connection::Host> m_nodes;
+    QHash<RedisClient::Connection::Host, int> m_nodeIndexes;
+    QHash<RedisClient::Connection::Host, QSharedPointer<RedisClient::Connection>> m_connections;
+    bool m_loaded;
+};
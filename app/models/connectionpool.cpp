@@ -0,0 +1,131 @@
+#include "connectionpool.h"
+#include <QMutexLocker>
+#include <QtConcurrent>
+
+
+ConnectionPool::ConnectionPool() {}
+
+ConnectionPool::~ConnectionPool() {
+    disconnectLanes();
+}
+
+QSharedPointer<RedisClient::Connection> ConnectionPool::connection(Lane lane) {
+    QSharedPointer<RedisClient::Connection> connection;
+    CreatedCallback created;
+    {
+        QMutexLocker locker(&m_lock);
+
+        if (lane == Lane::Interactive || !m_interactive) {
+            return m_interactive;
+        }
+
+        connection = m_lanes.value(static_cast<int>(lane));
+        if (connection) {
+            return connection;
+        }
+
+        connection = m_interactive->clone();
+        m_lanes.insert(static_cast<int>(lane), connection);
+        created = m_createdCallback;
+    }
+
+    if (created) {
+        created(lane, *connection);
+    }
+    return connection;
+}
+
+QSharedPointer<RedisClient::Connection> ConnectionPool::nodeConnection(const RedisClient::Connection::Host &node) {
+    QSharedPointer<RedisClient::Connection> connection;
+    CreatedCallback created;
+    {
+        QMutexLocker locker(&m_lock);
+
+        if (!m_interactive) {
+            return m_interactive;
+        }
+
+        connection = m_nodes.value(node);
+        if (connection) {
+            return connection;
+        }
+
+        RedisClient::ConnectionConfig config = m_interactive->getConfig();
+        if (!config.overrideClusterHost()) {
+            config.setHost(node.first);
+        }
+        config.setPort(node.second);
+
+        connection = m_interactive->clone(false);
+        connection->setConnectionConfig(config);
+        m_nodes.insert(node, connection);
+        created = m_createdCallback;
+    }
+
+    if (created) {
+        created(Lane::Scan, *connection);
+    }
+    return connection;
+}
+
+void ConnectionPool::setCreatedCallback(CreatedCallback callback) {
+    QMutexLocker locker(&m_lock);
+    m_createdCallback = callback;
+}
+
+void ConnectionPool::reset(QSharedPointer<RedisClient::Connection> interactive) {
+    disconnectLanes();
+
+    QMutexLocker locker(&m_lock);
+    m_interactive = interactive;
+}
+
+QList<QSharedPointer<RedisClient::Connection>> ConnectionPool::connections() {
+    QMutexLocker locker(&m_lock);
+
+    QList<QSharedPointer<RedisClient::Connection>> result = m_lanes.values() + m_nodes.values();
+    if (m_interactive) {
+        result.prepend(m_interactive);
+    }
+    return result;
+}
+
+void ConnectionPool::setConnectionConfig(const RedisClient::ConnectionConfig& config) {
+    QList<QSharedPointer<RedisClient::Connection>> nodes;
+    {
+        QMutexLocker locker(&m_lock);
+        for (auto connection : m_lanes) {
+            connection->setConnectionConfig(config);
+        }
+
+        // NOTE: node connections are recreated from new config on demand
+        nodes = m_nodes.values();
+        m_nodes.clear();
+    }
+    disconnectAll(nodes);
+}
+
+void ConnectionPool::disconnect() {
+    disconnectLanes();
+}
+
+void ConnectionPool::disconnectLanes() {
+    QList<QSharedPointer<RedisClient::Connection>> lanes;
+    {
+        QMutexLocker locker(&m_lock);
+        lanes = m_lanes.values() + m_nodes.values();
+        m_lanes.clear();
+        m_nodes.clear();
+    }
+    disconnectAll(lanes);
+}
+
+void ConnectionPool::disconnectAll(QList<QSharedPointer<RedisClient::Connection>> connections) {
+    if (connections.isEmpty()) { return; }
+
+    QtConcurrent::run([connections]() {
+        for (auto connection : connections) {
+            connection->disconnect();
+        }
+    });
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+#include <functional>
+#include "connection.h"
+
+
+// Connections of one server grouped by purpose.
+// Interactive lane is the main connection used by value editor and console,
+// other lanes are cloned from it once and reused, so long key scans and bulk
+// jobs neither queue behind nor block interactive commands.
+class ConnectionPool {
+public:
+    enum class Lane { Interactive, Scan, Bulk };
+    typedef std::function<void(Lane, RedisClient::Connection &)> CreatedCallback;
+
+    ConnectionPool();
+    ~ConnectionPool();
+
+    QSharedPointer<RedisClient::Connection> connection(Lane lane = Lane::Interactive);
+
+    // Connection to specific cluster node, reused between calls
+    QSharedPointer<RedisClient::Connection> nodeConnection(const RedisClient::Connection::Host &node);
+
+    // Called for every newly cloned connection, e.g. to register logger.
+    // Callback is called without pool lock held.
+    void setCreatedCallback(CreatedCallback callback);
+
+    // Replaces main connection, pooled connections are disconnected and recreated on demand
+    void reset(QSharedPointer<RedisClient::Connection> interactive);
+
+    // Main connection and all pooled connections created so far
+    QList<QSharedPointer<RedisClient::Connection>> connections();
+
+    // Applies config to all pooled connections
+    void setConnectionConfig(const RedisClient::ConnectionConfig& config);
+
+    void disconnect();
+
+private:
+    void disconnectLanes();
+    static void disconnectAll(QList<QSharedPointer<RedisClient::Connection>> connections);
+
+private:
+    QMutex m_lock;
+    QSharedPointer<RedisClient::Connection> m_interactive;
+    CreatedCallback m_createdCallback;
+    QHash<int, QSharedPointer<RedisClient::Connection>> m_lanes;
+    QHash<RedisClient::Connection::Host, QSharedPointer<RedisClient::Connection>> m_nodes;
+};
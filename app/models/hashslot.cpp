@@ -0,0 +1,80 @@
+#include "hashslot.h"
+#include <array>
+#include <cstring>
+
+
+namespace {
+    typedef std::array<std::array<quint16, 256>, 8> Tables;
+
+    // tables[0] is classic byte-wise table of polynomial 0x1021, tables[k]
+    // advances CRC of a byte by k more zero bytes
+    constexpr Tables makeTables() {
+        Tables tables{};
+        for (int b = 0; b < 256; ++b) {
+            quint16 crc = static_cast<quint16>(b << 8);
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = static_cast<quint16>(crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1);
+            }
+            tables[0][b] = crc;
+        }
+        for (int k = 1; k < 8; ++k) {
+            for (int b = 0; b < 256; ++b) {
+                quint16 prev = tables[k - 1][b];
+                tables[k][b] = static_cast<quint16>((prev << 8) ^ tables[0][prev >> 8]);
+            }
+        }
+        return tables;
+    }
+
+    constexpr Tables tables = makeTables();
+}
+
+
+quint16 HashSlot::crc16(const char* data, int size) {
+    auto p = reinterpret_cast<const uchar*>(data);
+    quint16 crc = 0;
+
+    while (size >= 8) {
+        crc = tables[7][p[0] ^ (crc >> 8)] ^ tables[6][p[1] ^ (crc & 0xff)]
+            ^ tables[5][p[2]] ^ tables[4][p[3]] ^ tables[3][p[4]]
+            ^ tables[2][p[5]] ^ tables[1][p[6]] ^ tables[0][p[7]];
+        p += 8;
+        size -= 8;
+    }
+
+    while (size-- > 0) {
+        crc = static_cast<quint16>((crc << 8) ^ tables[0][(crc >> 8) ^ *p++]);
+    }
+    return crc;
+}
+
+void HashSlot::hashedPart(const char* key, int size, const char*& data, int& length) {
+    data = key;
+    length = size;
+
+    auto open = static_cast<const char*>(memchr(key, '{', size));
+    if (!open) { return; }
+
+    const char* tagStart = open + 1;
+    auto close = static_cast<const char*>(memchr(tagStart, '}', key + size - tagStart));
+    if (!close || close == tagStart) { return; }
+
+    data = tagStart;
+    length = static_cast<int>(close - tagStart);
+}
+
+quint16 HashSlot::keySlot(const char* key, int size) {
+    const char* data;
+    int length;
+    hashedPart(key, size, data, length);
+    return crc16(data, length) & (SLOTS_COUNT - 1);
+}
+
+QVector<quint16> HashSlot::keySlots(const RedisClient::Connection::RawKeysList& keys) {
+    QVector<quint16> slots;
+    slots.reserve(keys.size());
+    for (const QByteArray& key : keys) {
+        slots.append(keySlot(key.constData(), key.size()));
+    }
+    return slots;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <QByteArray>
+#include <QVector>
+#include "connection.h"
+
+// Cluster hash slots of keys.
+// CRC16 (XMODEM) is computed 8 bytes per step with slicing-by-8 tables, and
+// {hashtag} is located in place, so computing slots of a big key batch
+// doesn't copy key names.
+namespace HashSlot {
+
+    const int SLOTS_COUNT = 16384;
+
+    quint16 crc16(const char* data, int size);
+
+    // Part of key which is hashed: content of the first non-empty {hashtag} or whole key
+    void hashedPart(const char* key, int size, const char*& data, int& length);
+
+    quint16 keySlot(const char* key, int size);
+
+    inline quint16 keySlot(const QByteArray& key) { return keySlot(key.constData(), key.size()); }
+
+    QVector<quint16> keySlots(const RedisClient::Connection::RawKeysList& keys);
+
+}  // namespace HashSlot
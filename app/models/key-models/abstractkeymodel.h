@@ -10,24 +10,36 @@
 #include <QSharedPointer>
 #include <QString>
 #include <QVariant>
+#include <QVector>
 #include "modules/value-editor/keymodel.h"
+#include "app/models/clusterslotrouter.h"
+#include "app/models/replicarouter.h"
+#include "app/models/scancountcontroller.h"
+#include "columnpages.h"
+#include "keymetadata.h"
+#include "keymodelsignals.h"
+#include "rowprefetcher.h"
 #include "rowcache.h"
 
 
-template <typename T>
+template <typename T, typename Page = RowListPage<T>>
 class KeyModel : public ValueEditor::Model {
 public:
+  typedef MappedCache<T, Page> RowsCache;
+
   KeyModel(QSharedPointer<RedisClient::Connection> connection, QByteArray fullPath, int dbIndex, long long ttl, QByteArray rowsCountCmd = QByteArray(), QByteArray rowsLoadCmd = QByteArray())
       : m_connection(connection),
         m_keyFullPath(fullPath),
         m_dbIndex(dbIndex),
         m_ttl(ttl),
         m_rowCount(0),
+        m_rowCountPreloaded(false),
         m_isMultiRow(!rowsCountCmd.isEmpty()),
         m_rowsCountCmd(rowsCountCmd),
         m_rowsLoadCmd(rowsLoadCmd),
-        m_scanCursor(0),
-        m_notifier(new ValueEditor::ModelSignals(), &QObject::deleteLater) {}
+        m_notifier(new KeyModelSignals(), &QObject::deleteLater) {
+    m_searchCache.setEvictable(false);
+  }
 
   virtual ~KeyModel() {
     m_notifier.clear();
@@ -52,12 +64,49 @@ public:
 
   // 执行命令，参数 cmd，callback, cmdHandler, responseType
   // 通过 QSharedPointer<RedisClient::Connection> m_connection执行cmd()方法
+  // 写入的key在replica追上之前从master读取
   virtual void executeCmd(QList<QByteArray> cmd, Callback c, CmdHandler handler = CmdHandler(), RedisClient::Response::Type expectedType = RedisClient::Response::Type::Unknown) {
-    m_connection->cmd(
-                cmd,
-                m_notifier.data(),
-                -1,
-                [c, handler, expectedType](RedisClient::Response r) {
+    ReplicaRouter::pinToMaster(m_connection, m_keyFullPath);
+    executeCmdOn(m_connection, -1, cmd, c, handler, expectedType);
+  }
+
+  // 只读命令，开启了replica读取时发送到replica
+  virtual void executeReadCmd(QList<QByteArray> cmd, Callback c, CmdHandler handler = CmdHandler(), RedisClient::Response::Type expectedType = RedisClient::Response::Type::Unknown) {
+    int db = -1;
+    auto connection = readConnection(db);
+    executeCmdOn(connection, db, cmd, c, handler, expectedType);
+  }
+
+  // Replica connection if ReplicaRouter is enabled for m_connection, in cluster mode
+  // connection to the node which owns key slot.
+  // These connections don't share selected db with master, so db is set explicitly.
+  QSharedPointer<RedisClient::Connection> readConnection(int& db) const {
+    auto connection = ReplicaRouter::readConnection(m_connection, m_keyFullPath);
+    if (connection == m_connection) {
+      auto router = ClusterSlotRouter::of(m_connection.data());
+      auto node = router ? router->connectionFor(m_keyFullPath) : QSharedPointer<RedisClient::Connection>();
+      if (node) { connection = node; }
+    }
+    db = connection == m_connection ? -1 : m_dbIndex;
+    return connection;
+  }
+
+  // Connection for read-only scripts: cluster replicas reply to EVAL with MOVED
+  // even after READONLY, so in cluster mode scripts go to the node which owns key slot
+  QSharedPointer<RedisClient::Connection> scriptConnection(int& db) const {
+    if (m_connection->mode() != RedisClient::Connection::Mode::Cluster) {
+      return readConnection(db);
+    }
+
+    auto router = ClusterSlotRouter::of(m_connection.data());
+    auto node = router ? router->connectionFor(m_keyFullPath) : QSharedPointer<RedisClient::Connection>();
+    auto connection = node ? node : m_connection;
+    db = connection == m_connection ? -1 : m_dbIndex;
+    return connection;
+  }
+
+  void executeCmdOn(QSharedPointer<RedisClient::Connection> connection, int db, QList<QByteArray> cmd, Callback c, CmdHandler handler, RedisClient::Response::Type expectedType) {
+    auto onResponse = [c, handler, expectedType](RedisClient::Response r) {
                     // 如果 response type不正确，则返回提示信息
                     if (expectedType != RedisClient::Response::Type::Unknown && r.type() != expectedType) {
                         return c(QCoreApplication::translate("RDM", "Server returned unexpected response: ") + r.value().toString());
@@ -68,12 +117,19 @@ public:
                     } else {
                         return c(QString());
                     }
-                },
-                [c](QString err) {
+                };
+    auto onError = [c](QString err) {
                     // 如果 connection 错误，则返回错误信息
                     return c(QCoreApplication::translate("RDM", "Connection error: ") + err);
-                }
-    );
+                };
+
+    // NOTE: in cluster mode commands go straight to the node which owns key slot
+    auto router = ClusterSlotRouter::of(m_connection.data());
+    if (router && router->isActive()
+        && (connection == m_connection || connection == router->connectionFor(m_keyFullPath))) {
+      return router->execute(cmd, m_keyFullPath, m_notifier.data(), onResponse, onError);
+    }
+    connection->cmd(cmd, m_notifier.data(), db, onResponse, onError);
   }
 
 
@@ -132,6 +188,20 @@ public:
   }
   virtual long long getTTL() override { return m_ttl; }
 
+  // Length loaded together with key type is used as rows count until the first
+  // loadRowsCount(), which doesn't need another round trip then.
+  // Encoding and memory usage are shown in editor header, they are published
+  // in "encoding" and "memoryUsage" filters (empty if unknown).
+  void setMetadata(const KeyMetadata& metadata) {
+    if (!metadata.encoding.isEmpty()) { m_filters["encoding"] = QString::fromUtf8(metadata.encoding); }
+    if (metadata.memory >= 0) { m_filters["memoryUsage"] = metadata.memory; }
+
+    if (!isMultiRow() || metadata.length < 0) { return; }
+
+    m_rowCount = metadata.length;
+    m_rowCountPreloaded = true;
+  }
+
 
   virtual bool isMultiRow() const override { return m_isMultiRow; }
   virtual bool isRowLoaded(int rowIndex) override { return m_rowsCache.isRowLoaded(rowIndex); }
@@ -171,46 +241,123 @@ public:
 
   virtual void loadRows(QVariant rowStart, unsigned long count, LoadRowsCallback callback) override {
     if (m_rowsLoadCmd.mid(1, 4).toLower() == "scan") {
-      QList<QByteArray> cmdParts = {m_rowsLoadCmd, m_keyFullPath, QString::number(m_scanCursor).toLatin1(), "COUNT", QString::number(count).toLatin1()};
-
-      auto self = ValueEditor::Model::sharedFromThis().toWeakRef();
-
-      m_connection->cmd(cmdParts,
-                        m_notifier.data(),
-                        -1,
-                        [this, callback, rowStart, self](RedisClient::Response r) {
-                            if (!r.isValidScanResponse()) {
-                                callback(QCoreApplication::translate("RDM", "Cannot parse scan response"), 0);
-                                return;
-                            }
-
-                            if (r.getCursor() > 0) {
-                                m_scanCursor = r.getCursor();
-                            }
-
-                            try {
-                                unsigned long addedRows = addLoadedRowsToCache(r.getCollection(), rowStart);
-                                callback(QString(), addedRows);
-                            } catch (const std::runtime_error& e) {
-                                callback(QString(e.what()), 0);
-                            }
-                        },
-                        [self, callback](QString err) {
-                            if (!self) { return; }
-                            return callback(QCoreApplication::translate("RDM", "Connection error: ") + err, 0);
-                        });
+      // NOTE: cursor is remembered for every loaded page, so pages evicted from cache
+      // are reloaded from the nearest preceding cursor instead of the end of the scan
+      RowIndex target = rowStart.toLongLong();
+      RowIndex pageStart = 0;
+      long long cursor = 0;
+      auto checkpoint = m_scanPageCursors.upperBound(target);
+      if (checkpoint != m_scanPageCursors.begin()) {
+        --checkpoint;
+        pageStart = checkpoint.key();
+        cursor = checkpoint.value();
+      }
+
+      seekScan(target, pageStart, cursor, count, callback);
 
     } else {
-      getRowsRange(getRangeCmd(rowStart, count),
-                   [this, callback, rowStart](const QString& err, QVariantList result) {
-                        if (!err.isEmpty()) return callback(err, 0);
-                        unsigned long addedRows = addLoadedRowsToCache(result, rowStart);
-                        callback(QString(), addedRows);
-                   });
+      RowIndex start = rowStart.toLongLong();
+      if (canPrefetchRows()) { m_prefetcher.visit(start, count); }
+
+      if (m_pendingPages.contains(start)) {
+        // NOTE: page was requested by prefetcher, view waits for the same reply
+        m_pendingPages[start].waiters.append(callback);
+      } else {
+        loadPage(start, count, callback);
+      }
+
+      if (canPrefetchRows()) { prefetchRows(start, count); }
+    }
+  }
+
+  virtual void clearRowCache() override {
+    m_rowsCache.clear();
+    m_scanPageCursors.clear();
+    m_prefetcher.reset();
+    ++m_scanGeneration;
+    ++m_fillGeneration;
+    cancelSearch();
+
+    // NOTE: replies to pages requested before reset are dropped, pages which
+    // view waits for are requested again, prefetched ones are forgotten
+    QHash<RowIndex, PendingPage> pendingPages;
+    pendingPages.swap(m_pendingPages);
+    for (auto pending = pendingPages.constBegin(); pending != pendingPages.constEnd(); ++pending) {
+      for (const LoadRowsCallback& waiter : pending.value().waiters) {
+        loadRows(pending.key(), pending.value().count, waiter);
+      }
+    }
+  }
+
+  typedef std::function<void(const QString& err, RowIndex matchedRows, bool finished)> SearchCallback;
+
+  // Server-side search of values inside collection: only rows matching glob pattern
+  // are transferred. Found rows are streamed into a separate result cache, so rows
+  // of view and scan checkpoints stay untouched.
+  // Search is cancelled by the next search, cancelSearch() or clearRowCache().
+  virtual void searchRows(const QByteArray& pattern, SearchCallback progress) {
+    cancelSearch();
+
+    QByteArray scanCmd = searchScanCmd();
+    if (scanCmd.isEmpty()) {
+      return progress(QCoreApplication::translate("RDM", "Search is not supported for this key type"), 0, true);
+    }
+    searchPage(scanCmd, pattern, 0, m_searchGeneration, progress);
+  }
+
+  void cancelSearch() {
+    ++m_searchGeneration;
+    m_searchCache.clear();
+    m_searchRowIndexes.clear();
+    m_searchRowsCount = 0;
+    m_filters.remove("searchMatches");
+    m_filters.remove("searchRowNumbers");
+    emit m_notifier->filtersChanged({"searchMatches", "searchRowNumbers"});
+  }
+
+  // Search started by view with "search" filter, empty pattern cancels it.
+  // Found rows are published in "searchMatches" filter, positions of rows in
+  // list in "searchRowNumbers" (empty for hash, set and zset), progress in
+  // "searchRows", "searchFinished" and "searchError" filters.
+  void startSearch(const QByteArray& pattern) {
+    cancelSearch();
+    reportSearch(QString(), pattern.isEmpty());
+    if (pattern.isEmpty()) { return; }
+
+    searchRows(pattern, [this](const QString& err, RowIndex, bool finished) {
+      reportSearch(err, finished);
+    });
+  }
+
+  void reportSearch(const QString& err, bool finished) {
+    // NOTE: only rows found since the previous report are converted
+    QVariantList matches = m_filters.take("searchMatches").toList();
+    for (RowIndex result = matches.size(); result < m_searchRowsCount; ++result) {
+      matches.append(rowToVariant(m_searchCache.getRow(result)));
+    }
+    m_filters["searchMatches"] = matches;
+
+    QVariantList rowNumbers = m_filters.take("searchRowNumbers").toList();
+    for (int result = rowNumbers.size(); result < m_searchRowIndexes.size(); ++result) {
+      rowNumbers.append(m_searchRowIndexes.at(result));
     }
+    m_filters["searchRowNumbers"] = rowNumbers;
+
+    m_filters["searchRows"] = m_searchRowsCount;
+    m_filters["searchFinished"] = finished;
+    m_filters["searchError"] = err;
+    emit m_notifier->filtersChanged({"searchMatches", "searchRowNumbers", "searchRows", "searchFinished", "searchError"});
+  }
+
+  static QVariant rowToVariant(const QByteArray& row) { return row; }
+
+  template <typename First, typename Second>
+  static QVariant rowToVariant(const QPair<First, Second>& row) {
+    return QVariantList{row.first, row.second};
   }
 
-  virtual void clearRowCache() override { m_rowsCache.clear(); }
+  // Approximate amount of memory used by loaded rows
+  virtual qulonglong cacheMemoryUsage() const { return m_rowsCache.memoryUsage(); }
 
 
 
@@ -222,7 +369,12 @@ public:
       return c(QString());
     }
 
-    executeCmd({m_rowsCountCmd, m_keyFullPath},
+    if (m_rowCountPreloaded) {
+      m_rowCountPreloaded = false;
+      return c(QString());
+    }
+
+    executeReadCmd({m_rowsCountCmd, m_keyFullPath},
                c,
                [this](RedisClient::Response r, Callback c) {
                     m_rowCount = r.value().toUInt();
@@ -239,7 +391,42 @@ protected:
     void setFilter(const QString& k, QVariant v) override {
         m_filters[k] = v;
         qDebug() << "filter:" << k << v;
+
+        if (k == "fill") {
+          v.toBool() ? fillRows() : stopFill();
+        } else if (k == "search") {
+          startSearch(v.toByteArray());
+        }
+    }
+
+  // Background fill for SCAN-backed keys, started and stopped by view with "fill" filter:
+  // scans the rest of collection page by page without waiting for view, so later
+  // jumps are served from cache. Progress is reported in "fillRows", "fillFinished"
+  // and "fillError" filters. Stops when the collection is loaded or the next page
+  // wouldn't fit into row cache limit of model.
+  void fillRows() {
+    if (m_rowsLoadCmd.mid(1, 4).toLower() != "scan") {
+      return reportFill(QString(), static_cast<RowIndex>(m_rowsCache.size()), true);
+    }
+
+    RowIndex pageStart = 0;
+    long long cursor = 0;
+    if (!m_scanPageCursors.isEmpty()) {
+      pageStart = m_scanPageCursors.lastKey();
+      cursor = m_scanPageCursors.last();
     }
+    reportFill(QString(), pageStart, false);
+    fillPage(pageStart, cursor, ++m_fillGeneration);
+  }
+
+  void stopFill() { ++m_fillGeneration; }
+
+  void reportFill(const QString& err, RowIndex loadedRows, bool finished) {
+    m_filters["fillRows"] = loadedRows;
+    m_filters["fillFinished"] = finished;
+    m_filters["fillError"] = err;
+    emit m_notifier->filtersChanged({"fillRows", "fillFinished", "fillError"});
+  }
 
   // row validator
   virtual bool isRowValid(const QVariantMap& row) {
@@ -284,26 +471,204 @@ protected:
   }
 
   virtual void getRowsRange(const QList<QByteArray>& rangeCmd, std::function<void(const QString&, QVariantList)> callback) {
-    try {
-      m_connection->command(rangeCmd,
-                            getConnector().data(),
-                            [this, callback](RedisClient::Response r, QString e) {
-                                if (!e.isEmpty()) {
-                                    return callback(e, QVariantList());
-                                }
-
-                                if (r.type() != RedisClient::Response::Array) {
-                                    return callback(QCoreApplication::translate("RDM", "Cannot load rows for key %1: %2").arg(getKeyName()), QVariantList());
-                                }
-
-                                return callback(QString(), r.value().toList());
-                            },
-                            -1);
-    } catch (const RedisClient::Connection::Exception& e) {
-        callback(QCoreApplication::translate("RDM", "Cannot load rows for key %1: %2").arg(getKeyName()).arg(e.what()), QVariantList());
+    executeReadCmd(rangeCmd,
+                   [callback](const QString& err) { callback(err, QVariantList()); },
+                   [this, callback](RedisClient::Response r, Callback) {
+                       if (r.type() != RedisClient::Response::Array) {
+                           return callback(QCoreApplication::translate("RDM", "Cannot load rows for key %1: %2").arg(getKeyName()).arg(r.value().toString()), QVariantList());
+                       }
+
+                       return callback(QString(), r.value().toList());
+                   });
+  }
+
+  typedef std::function<void(const QString& err, unsigned long addedRows, long long nextCursor)> ScanPageCallback;
+
+  // Scans pages from checkpoint until the page with target row is loaded,
+  // every page on the way leaves a checkpoint for later jumps
+  void seekScan(RowIndex target, RowIndex pageStart, long long cursor, unsigned long count, LoadRowsCallback callback) {
+    quint64 generation = m_scanGeneration;
+    scanPage(pageStart, cursor, count,
+             [this, target, pageStart, count, generation, callback](const QString& err, unsigned long addedRows, long long nextCursor) {
+                  if (!err.isEmpty()) { return callback(err, 0); }
+                  if (generation != m_scanGeneration) { return callback(QString(), 0); }
+
+                  RowIndex pageEnd = pageStart + addedRows;
+                  if (target < pageEnd || nextCursor == 0) { return callback(QString(), addedRows); }
+                  seekScan(target, pageEnd, nextCursor, count, callback);
+             });
+  }
+
+  void scanPage(RowIndex pageStart, long long cursor, unsigned long count, ScanPageCallback callback) {
+    // NOTE: page size requested by view is only a hint, COUNT follows measured server latency
+    int db = -1;
+    auto connection = readConnection(db);
+    ScanCountController* controller = ScanCountController::of(connection.data(), m_rowsLoadCmd);
+    long scanCount = controller->count();
+
+    QList<QByteArray> cmdParts = {m_rowsLoadCmd, m_keyFullPath, QString::number(cursor).toLatin1(), "COUNT", QString::number(scanCount).toLatin1()};
+
+    auto self = ValueEditor::Model::sharedFromThis().toWeakRef();
+    quint64 generation = m_scanGeneration;
+
+    controller->run(connection.data(), cmdParts, scanCount,
+                      m_notifier.data(),
+                      db,
+                      [this, callback, self, generation, pageStart, cursor](const RedisClient::Response& r) {
+                          // NOTE: page of a scan which was started before row cache was cleared
+                          // must not leave rows or cursor checkpoints behind
+                          if (!self) { return; }
+                          if (generation != m_scanGeneration) { return callback(QString(), 0, 0); }
+
+                          if (!r.isValidScanResponse()) {
+                              callback(QCoreApplication::translate("RDM", "Cannot parse scan response"), 0, 0);
+                              return;
+                          }
+
+                          m_scanPageCursors[pageStart] = cursor;
+
+                          try {
+                              unsigned long addedRows = addLoadedRowsToCache(r.getCollection(), pageStart, m_rowsCache);
+                              if (r.getCursor() > 0) {
+                                  m_scanPageCursors[pageStart + addedRows] = r.getCursor();
+                              }
+                              callback(QString(), addedRows, r.getCursor());
+                          } catch (const std::runtime_error& e) {
+                              callback(QString(e.what()), 0, 0);
+                          }
+                      },
+                      [self, callback](QString err) {
+                          if (!self) { return; }
+                          return callback(QCoreApplication::translate("RDM", "Connection error: ") + err, 0, 0);
+                      });
+  }
+
+  void fillPage(RowIndex pageStart, long long cursor, quint64 generation) {
+    scanPage(pageStart, cursor, DEFAULT_FILL_PAGE,
+             [this, pageStart, generation](const QString& err, unsigned long addedRows, long long nextCursor) {
+                  if (generation != m_fillGeneration) { return; }
+                  if (!err.isEmpty()) { return reportFill(err, pageStart, true); }
+
+                  RowIndex loadedRows = pageStart + addedRows;
+                  if (nextCursor == 0) { return reportFill(QString(), loadedRows, true); }
+
+                  // NOTE: row cache evicts its oldest pages instead of growing over model
+                  // limit, so fill stops before the next page of the same size would be added
+                  qulonglong cachedRows = m_rowsCache.size();
+                  qulonglong usage = m_rowsCache.memoryUsage();
+                  qulonglong nextPageBytes = cachedRows > 0 ? usage / cachedRows * addedRows : 0;
+                  if (usage + nextPageBytes > RowCacheBudget::modelLimit()) {
+                    return reportFill(QCoreApplication::translate("RDM", "Row cache limit is reached, collection is loaded partially"), loadedRows, true);
+                  }
+
+                  reportFill(QString(), loadedRows, false);
+                  fillPage(loadedRows, nextCursor, generation);
+             });
+  }
+
+  // SCAN command which is used by searchRows() with MATCH, empty if key type can't be searched on server
+  virtual QByteArray searchScanCmd() const {
+    return m_rowsLoadCmd.mid(1, 4).toLower() == "scan" ? m_rowsLoadCmd : QByteArray();
+  }
+
+  void searchPage(const QByteArray& scanCmd, const QByteArray& pattern, long long cursor, quint64 generation, SearchCallback progress) {
+    // NOTE: MATCH is applied after COUNT elements are visited, so pages of search
+    // cost the server as much as pages of view and use the same COUNT
+    int db = -1;
+    auto connection = readConnection(db);
+    ScanCountController* controller = ScanCountController::of(connection.data(), scanCmd);
+    long scanCount = controller->count();
+
+    QList<QByteArray> cmdParts = {scanCmd, m_keyFullPath, QString::number(cursor).toLatin1(),
+                                  "MATCH", pattern, "COUNT", QString::number(scanCount).toLatin1()};
+
+    auto self = ValueEditor::Model::sharedFromThis().toWeakRef();
+
+    controller->run(connection.data(), cmdParts, scanCount,
+                      m_notifier.data(),
+                      db,
+                      [this, self, scanCmd, pattern, generation, progress](const RedisClient::Response& r) {
+                          if (!self || generation != m_searchGeneration) { return; }
+
+                          if (!r.isValidScanResponse()) {
+                              return progress(QCoreApplication::translate("RDM", "Cannot parse scan response"), m_searchRowsCount, true);
+                          }
+
+                          try {
+                              addSearchResults(r.getCollection());
+                          } catch (const std::runtime_error& e) {
+                              return progress(QString(e.what()), m_searchRowsCount, true);
+                          }
+
+                          if (r.getCursor() == 0) { return progress(QString(), m_searchRowsCount, true); }
+
+                          if (m_searchCache.memoryUsage() >= RowCacheBudget::modelLimit()) {
+                              return progress(QCoreApplication::translate("RDM", "Row cache limit is reached, only part of matching rows is loaded"), m_searchRowsCount, true);
+                          }
+
+                          progress(QString(), m_searchRowsCount, false);
+                          searchPage(scanCmd, pattern, r.getCursor(), generation, progress);
+                      },
+                      [this, self, generation, progress](QString err) {
+                          if (!self || generation != m_searchGeneration) { return; }
+                          return progress(QCoreApplication::translate("RDM", "Connection error: ") + err, m_searchRowsCount, true);
+                      });
+  }
+
+  // Adds rows to search results instead of rows of view, rowIndexes are positions
+  // of rows in collection if they are known
+  void addSearchResults(const QVariantList& rows, const QVector<RowIndex>& rowIndexes = QVector<RowIndex>()) {
+    m_searchRowsCount += addLoadedRowsToCache(rows, m_searchRowsCount, m_searchCache);
+    m_searchRowIndexes += rowIndexes;
+  }
+
+  // Pages can be loaded by row index without loading preceding pages first
+  virtual bool canPrefetchRows() const { return true; }
+
+  // Page can be prefetched now, otherwise it is tried again on next visit of view
+  virtual bool canPrefetchPage(RowIndex) const { return true; }
+
+  // Loads page in the scroll direction before view asks for it. Prefetches are
+  // sent right after the requested page, without waiting for its reply.
+  void prefetchRows(RowIndex start, unsigned long count) {
+    for (const CacheRange& page : m_prefetcher.pagesAhead(start, count, m_rowCount)) {
+      if (m_pendingPages.contains(page.first) || !canPrefetchPage(page.first)
+          || m_rowsCache.isRowLoaded(page.first) || m_rowsCache.isRowLoaded(page.second)) {
+        continue;
+      }
+      loadPage(page.first, page.second - page.first + 1, LoadRowsCallback());
     }
   }
 
+  void loadPage(RowIndex start, unsigned long count, LoadRowsCallback callback) {
+    quint64 generation = m_prefetcher.generation();
+    PendingPage& pending = m_pendingPages[start];
+    pending.generation = generation;
+    pending.count = count;
+    if (callback) { pending.waiters.append(callback); }
+
+    getRowsRange(getRangeCmd(start, count),
+                 [this, start, generation](const QString& err, QVariantList result) {
+                      QList<LoadRowsCallback> waiters;
+                      auto pending = m_pendingPages.find(start);
+                      if (pending != m_pendingPages.end() && pending.value().generation == generation) {
+                        waiters = pending.value().waiters;
+                        m_pendingPages.erase(pending);
+                      }
+
+                      // NOTE: nobody waits for prefetched page which went out of view
+                      if (waiters.isEmpty() && !m_prefetcher.isCurrent(generation)) { return; }
+
+                      if (!err.isEmpty()) {
+                        for (auto& waiter : waiters) { waiter(err, 0); }
+                        return;
+                      }
+
+                      unsigned long addedRows = addLoadedRowsToCache(result, start, m_rowsCache);
+                      for (auto& waiter : waiters) { waiter(QString(), addedRows); }
+                 });
+  }
+
   virtual void setRemovedIfEmpty() {
     if (m_rowCount == 0) {
         m_notifier->removed();
@@ -311,7 +676,8 @@ protected:
   }
 
 
-  virtual int addLoadedRowsToCache(const QVariantList& rows, QVariant rowStart) = 0;
+  // Adds rows to target cache: rows of view or search results
+  virtual int addLoadedRowsToCache(const QVariantList& rows, QVariant rowStart, RowsCache& target) = 0;
 
 
 
@@ -321,15 +687,33 @@ protected:
     int m_dbIndex;
     long long m_ttl;
     unsigned long m_rowCount;
+    bool m_rowCountPreloaded;
     bool m_isMultiRow;
 
     // CMD strings
     QByteArray m_rowsCountCmd;
     QByteArray m_rowsLoadCmd;
 
-    MappedCache<T> m_rowsCache;
-    long long m_scanCursor;
-    QSharedPointer<ValueEditor::ModelSignals> m_notifier;
+    MappedCache<T, Page> m_rowsCache;
+    QMap<RowIndex, long long> m_scanPageCursors;
+    quint64 m_scanGeneration = 0;
+    quint64 m_fillGeneration = 0;
+    static const unsigned long DEFAULT_FILL_PAGE = 1000;
+
+    // NOTE: search results are not evicted, search stops at row cache limit instead
+    MappedCache<T, Page> m_searchCache;
+    QVector<RowIndex> m_searchRowIndexes;
+    RowIndex m_searchRowsCount = 0;
+    quint64 m_searchGeneration = 0;
+
+    struct PendingPage {
+        quint64 generation = 0;
+        unsigned long count = 0;
+        QList<LoadRowsCallback> waiters;
+    };
+    RowPrefetcher m_prefetcher;
+    QHash<RowIndex, PendingPage> m_pendingPages;
+    QSharedPointer<KeyModelSignals> m_notifier;
 
     QVariantMap m_filters;
 };
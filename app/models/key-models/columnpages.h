@@ -0,0 +1,159 @@
+#pragma once
+#include <QByteArray>
+#include <QList>
+#include <QPair>
+#include <QVector>
+
+
+// Columnar pages for MappedCache.
+// Strings of all rows in a page are stored back to back in one arena and
+// located by offsets, so a page costs a few allocations no matter how many
+// rows it holds and per-row overhead is an offset per column.
+// Pages are built once per loaded range, edits of single rows rebuild the page.
+// Cell accessors return owning copies, cells are handed to the view and the
+// page may be rebuilt by an edit or evicted by any model in the meantime.
+
+// Rows of two strings: hash field and value
+class PairColumnPage {
+public:
+    typedef QPair<QByteArray, QByteArray> Row;
+
+    PairColumnPage() { m_offsets.append(0); }
+    explicit PairColumnPage(const QList<Row>& rows) { build(rows); }
+
+    int size() const { return (m_offsets.size() - 1) / 2; }
+
+    QByteArray first(int i) const { return copy(2 * i); }
+    QByteArray second(int i) const { return copy(2 * i + 1); }
+    Row at(int i) const { return {copy(2 * i), copy(2 * i + 1)}; }
+
+    void reserve(int rows, int payloadBytes) {
+        m_offsets.reserve(2 * rows + 1);
+        m_arena.reserve(payloadBytes);
+    }
+
+    void append(const char* first, int firstSize, const char* second, int secondSize) {
+        m_arena.append(first, firstSize);
+        m_offsets.append(m_arena.size());
+        m_arena.append(second, secondSize);
+        m_offsets.append(m_arena.size());
+    }
+
+    void append(const Row& row) { append(row.first.constData(), row.first.size(), row.second.constData(), row.second.size()); }
+
+    void replace(int i, const Row& row) {
+        QList<Row> rows = toList();
+        rows.replace(i, row);
+        build(rows);
+    }
+
+    void removeAt(int i) {
+        QList<Row> rows = toList();
+        rows.removeAt(i);
+        build(rows);
+    }
+
+    qulonglong bytes() const {
+        return sizeof(*this) + m_arena.capacity() + m_offsets.capacity() * sizeof(int);
+    }
+
+private:
+    QByteArray copy(int column) const {
+        return QByteArray(m_arena.constData() + m_offsets.at(column), m_offsets.at(column + 1) - m_offsets.at(column));
+    }
+
+    QList<Row> toList() const {
+        QList<Row> rows;
+        rows.reserve(size());
+        for (int i = 0; i < size(); ++i) { rows.append(at(i)); }
+        return rows;
+    }
+
+    void build(const QList<Row>& rows) {
+        int payload = 0;
+        for (const Row& row : rows) { payload += row.first.size() + row.second.size(); }
+
+        m_arena = QByteArray();
+        m_offsets = QVector<int>();
+        m_offsets.append(0);
+        reserve(rows.size(), payload);
+        for (const Row& row : rows) { append(row); }
+    }
+
+private:
+    QByteArray m_arena;
+    QVector<int> m_offsets;     // row i is [2i, 2i + 1) and [2i + 1, 2i + 2)
+};
+
+
+// Rows of a string and a score: sorted set member and score
+class ScoredColumnPage {
+public:
+    typedef QPair<QByteArray, double> Row;
+
+    ScoredColumnPage() { m_offsets.append(0); }
+    explicit ScoredColumnPage(const QList<Row>& rows) { build(rows); }
+
+    int size() const { return m_scores.size(); }
+
+    QByteArray member(int i) const {
+        return QByteArray(m_arena.constData() + m_offsets.at(i), m_offsets.at(i + 1) - m_offsets.at(i));
+    }
+    double score(int i) const { return m_scores.at(i); }
+    Row at(int i) const { return {member(i), score(i)}; }
+
+    void reserve(int rows, int payloadBytes) {
+        m_offsets.reserve(rows + 1);
+        m_scores.reserve(rows);
+        m_arena.reserve(payloadBytes);
+    }
+
+    void append(const char* member, int memberSize, double score) {
+        m_arena.append(member, memberSize);
+        m_offsets.append(m_arena.size());
+        m_scores.append(score);
+    }
+
+    void append(const Row& row) { append(row.first.constData(), row.first.size(), row.second); }
+
+    void replace(int i, const Row& row) {
+        QList<Row> rows = toList();
+        rows.replace(i, row);
+        build(rows);
+    }
+
+    void removeAt(int i) {
+        QList<Row> rows = toList();
+        rows.removeAt(i);
+        build(rows);
+    }
+
+    qulonglong bytes() const {
+        return sizeof(*this) + m_arena.capacity() + m_offsets.capacity() * sizeof(int) + m_scores.capacity() * sizeof(double);
+    }
+
+private:
+    QList<Row> toList() const {
+        QList<Row> rows;
+        rows.reserve(size());
+        for (int i = 0; i < size(); ++i) { rows.append(at(i)); }
+        return rows;
+    }
+
+    void build(const QList<Row>& rows) {
+        int payload = 0;
+        for (const Row& row : rows) { payload += row.first.size(); }
+
+        m_arena = QByteArray();
+        m_offsets = QVector<int>();
+        m_scores = QVector<double>();
+        m_offsets.append(0);
+        reserve(rows.size(), payload);
+        for (const Row& row : rows) { append(row); }
+    }
+
+private:
+    QByteArray m_arena;
+    QVector<int> m_offsets;     // member i is [i, i + 1)
+    QVector<double> m_scores;
+};
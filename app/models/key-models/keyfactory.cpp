@@ -13,11 +13,80 @@
 #include "keymodelsetsorted.h"
 #include "keymodelstream.h"
 #include "keymodelstring.h"
+#include "app/models/clusterslotrouter.h"
+#include "app/models/luascript.h"
+
+namespace {
+    // KEYS[1]: key
+    // Returns: {type, pttl, length, encoding, memory}
+    // OBJECT ENCODING and MEMORY USAGE may be missing or denied by ACL, "" and -1 are returned then
+    const QByteArray KEY_METADATA_SCRIPT = R"lua(
+local key = KEYS[1]
+local keyType = redis.call('TYPE', key)['ok']
+if keyType == 'none' then
+    return {keyType, -2, -1, '', -1}
+end
+
+local lengthCmd = {string = 'STRLEN', list = 'LLEN', set = 'SCARD', zset = 'ZCARD', hash = 'HLEN', stream = 'XLEN'}
+local length = -1
+if lengthCmd[keyType] then
+    length = redis.call(lengthCmd[keyType], key)
+end
+
+local ok, encoding = pcall(redis.call, 'OBJECT', 'ENCODING', key)
+if not ok or not encoding then encoding = '' end
+
+local memory
+ok, memory = pcall(redis.call, 'MEMORY', 'USAGE', key)
+if not ok or not memory then memory = -1 end
+
+return {keyType, redis.call('PTTL', key), length, encoding, memory}
+)lua";
+
+    template <typename M>
+    QSharedPointer<ValueEditor::Model> withMetadata(M* model, const KeyMetadata& metadata) {
+        model->setMetadata(metadata);
+        return QSharedPointer<ValueEditor::Model>(model);
+    }
+}
+
 
 KeyFactory::KeyFactory() {}
 
 void KeyFactory::loadKey(QSharedPointer<RedisClient::Connection> connection, QByteArray keyFullPath, int dbIndex, std::function<void(QSharedPointer<ValueEditor::Model>, const QString&)> callback) {
-    auto loadModel = [this, connection, keyFullPath, dbIndex, callback](RedisClient::Response resp, QString) {
+    static const LuaScript metadataScript(KEY_METADATA_SCRIPT);
+
+    // NOTE: metadata is read from master (slot owner in cluster), replica may not have
+    // a key which was created a moment ago
+    auto reader = connection;
+    auto router = ClusterSlotRouter::of(connection.data());
+    auto node = router ? router->connectionFor(keyFullPath) : QSharedPointer<RedisClient::Connection>();
+    if (node) { reader = node; }
+
+    // NOTE: all metadata is loaded in one round trip, TYPE + TTL are used if scripts are not allowed
+    metadataScript.eval(reader.data(), {keyFullPath}, {}, this, dbIndex, [this, connection, reader, keyFullPath, dbIndex, callback](RedisClient::Response r, QString err) {
+        if (!err.isEmpty()) {
+            return loadKeyType(connection, reader, keyFullPath, dbIndex, callback);
+        }
+
+        QSharedPointer<ValueEditor::Model> result;
+        KeyMetadata metadata = KeyMetadata::fromReply(r.value().toList());
+        if (metadata.type == "none") {
+            QString msg(QCoreApplication::translate("RDM", "Cannot load key %1 because it doesn't exist in database. Please reload connection tree and try again."));
+            callback(result, msg.arg(printableString(keyFullPath)));
+            return;
+        }
+
+        result = createModel(QString::fromUtf8(metadata.type), connection, keyFullPath, dbIndex, metadata.ttl(), metadata);
+        if (!result) {
+            return callback(result, QCoreApplication::translate("RDM", "Unsupported Redis Data type %1").arg(QString::fromUtf8(metadata.type)));
+        }
+        callback(result, QString());
+    });
+}
+
+void KeyFactory::loadKeyType(QSharedPointer<RedisClient::Connection> connection, QSharedPointer<RedisClient::Connection> reader, QByteArray keyFullPath, int dbIndex, std::function<void(QSharedPointer<ValueEditor::Model>, const QString&)> callback) {
+    auto loadModel = [this, connection, reader, keyFullPath, dbIndex, callback](RedisClient::Response resp, QString) {
         // 如果 出错，则返回错误信息
         QSharedPointer<ValueEditor::Model> result;
         if (resp.isErrorMessage() || resp.type() != RedisClient::Response::Type::Status) {
@@ -52,13 +121,13 @@ void KeyFactory::loadKey(QSharedPointer<RedisClient::Connection> connection, QBy
             QString msg(QCoreApplication::translate("RDM", "Cannot load TTL for key %1, connection error occurred: %2"));
             callback(result, msg.arg(printableString(keyFullPath)).arg(err));
         };
-        connection->cmd({"ttl", keyFullPath}, this, -1, parseTtl, processTtlError);
+        reader->cmd({"ttl", keyFullPath}, this, dbIndex, parseTtl, processTtlError);
     };
 
     // 执行redis的command命令
     RedisClient::Command typeCmd({"type", keyFullPath}, this, loadModel, dbIndex);
     try {
-        RedisClient::Response typeResult = connection->runCommand(typeCmd);
+        RedisClient::Response typeResult = reader->runCommand(typeCmd);
         if (typeResult.isPermissionError()) {
             emit error(typeResult.value().toString());
         }
@@ -111,21 +180,21 @@ void KeyFactory::submitNewKeyRequest(NewKeyRequest r) {
 
 
 
-QSharedPointer<ValueEditor::Model> KeyFactory::createModel(QString type, QSharedPointer<RedisClient::Connection> connection, QByteArray keyFullPath, int dbIndex, long long ttl) {
+QSharedPointer<ValueEditor::Model> KeyFactory::createModel(QString type, QSharedPointer<RedisClient::Connection> connection, QByteArray keyFullPath, int dbIndex, long long ttl, const KeyMetadata& metadata) {
     if (type == "string") {
-        return QSharedPointer<ValueEditor::Model>(new StringKeyModel(connection, keyFullPath, dbIndex, ttl));
+        return withMetadata(new StringKeyModel(connection, keyFullPath, dbIndex, ttl), metadata);
     } else if (type == "list") {
-        return QSharedPointer<ValueEditor::Model>(new ListKeyModel(connection, keyFullPath, dbIndex, ttl));
+        return withMetadata(new ListKeyModel(connection, keyFullPath, dbIndex, ttl), metadata);
     } else if (type == "set") {
-        return QSharedPointer<ValueEditor::Model>(new SetKeyModel(connection, keyFullPath, dbIndex, ttl));
+        return withMetadata(new SetKeyModel(connection, keyFullPath, dbIndex, ttl), metadata);
     } else if (type == "zset") {
-        return QSharedPointer<ValueEditor::Model>(new SortedSetKeyModel(connection, keyFullPath, dbIndex, ttl));
+        return withMetadata(new SortedSetKeyModel(connection, keyFullPath, dbIndex, ttl), metadata);
     } else if (type == "hash") {
-        return QSharedPointer<ValueEditor::Model>(new HashKeyModel(connection, keyFullPath, dbIndex, ttl));
+        return withMetadata(new HashKeyModel(connection, keyFullPath, dbIndex, ttl), metadata);
     } else if (type == "ReJSON-RL") {
-        return QSharedPointer<ValueEditor::Model>(new ReJSONKeyModel(connection, keyFullPath, dbIndex, ttl));
+        return withMetadata(new ReJSONKeyModel(connection, keyFullPath, dbIndex, ttl), metadata);
     } else if (type == "stream") {
-        return QSharedPointer<ValueEditor::Model>(new StreamKeyModel(connection, keyFullPath, dbIndex, ttl));
+        return withMetadata(new StreamKeyModel(connection, keyFullPath, dbIndex, ttl), metadata);
     }
     return QSharedPointer<ValueEditor::Model>();
 }
@@ -2,6 +2,7 @@
 #include <QJSValue>
 #include "modules/exception.h"
 #include "modules/value-editor/abstractkeyfactory.h"
+#include "keymetadata.h"
 #include "newkeyrequest.h"
 
 class KeyFactory : public QObject, public ValueEditor::AbstractKeyFactory {
@@ -20,5 +21,6 @@ signals:
     void error(const QString& err);
 
 private:
-    QSharedPointer<ValueEditor::Model> createModel(QString type, QSharedPointer<RedisClient::Connection> connection, QByteArray keyFullPath, int dbIndex, long long ttl);
+    void loadKeyType(QSharedPointer<RedisClient::Connection> connection, QSharedPointer<RedisClient::Connection> reader, QByteArray keyFullPath, int dbIndex, std::function<void(QSharedPointer<ValueEditor::Model>, const QString&)> callback);
+    QSharedPointer<ValueEditor::Model> createModel(QString type, QSharedPointer<RedisClient::Connection> connection, QByteArray keyFullPath, int dbIndex, long long ttl, const KeyMetadata& metadata = KeyMetadata());
 };
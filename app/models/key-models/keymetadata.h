@@ -0,0 +1,29 @@
+#pragma once
+#include <QByteArray>
+#include <QVariantList>
+
+
+// Key properties which are loaded together with key type when key is opened.
+// -1 (or empty encoding) means that value is unknown, e.g. length of a module
+// type or MEMORY USAGE denied by ACL.
+struct KeyMetadata {
+  QByteArray type;
+  long long pttl = -1;
+  long long length = -1;
+  QByteArray encoding;
+  long long memory = -1;
+
+  // TTL in seconds, rounded like TTL command does
+  long long ttl() const { return pttl > 0 ? (pttl + 500) / 1000 : pttl; }
+
+  // {type, pttl, length, encoding, memory}
+  static KeyMetadata fromReply(const QVariantList& reply) {
+    KeyMetadata metadata;
+    metadata.type = reply.value(0).toByteArray();
+    metadata.pttl = reply.value(1, -1).toLongLong();
+    metadata.length = reply.value(2, -1).toLongLong();
+    metadata.encoding = reply.value(3).toByteArray();
+    metadata.memory = reply.value(4, -1).toLongLong();
+    return metadata;
+  }
+};
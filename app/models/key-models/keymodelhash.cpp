@@ -23,14 +23,15 @@ QStringList HashKeyModel::getColumnNames() {
 
 QVariant HashKeyModel::getData(int rowIndex, int dataRole) {
   // 如果不存在row，则返回空值
-  if (!isRowLoaded(rowIndex)) { return QVariant(); }
+  int offset = 0;
+  const PairColumnPage* page = m_rowsCache.pageOf(rowIndex, offset);
+  if (!page) { return QVariant(); }
 
   // 根据 dataRole，从row缓存中取出相关的值
-  QPair<QByteArray, QByteArray> row = m_rowsCache[rowIndex];
   if (dataRole == Roles::Key){
-    return row.first;
+    return page->first(offset);
   }else if (dataRole == Roles::Value){
-    return row.second;
+    return page->second(offset);
   }else if (dataRole == Roles::RowNumber){
     return rowIndex;
   }
@@ -132,27 +133,28 @@ void HashKeyModel::deleteHashRow(const QByteArray &hashKey, Callback c) {
 
 
 // 将载入的row添加到cache中
-int HashKeyModel::addLoadedRowsToCache(const QVariantList &rows, QVariant rowStartId) {
-  QList<QPair<QByteArray, QByteArray>> result;
-
-  // 使用STL只读遍历
-  for (QVariantList::const_iterator item = rows.begin(); item != rows.end(); ++item) {
-    QPair<QByteArray, QByteArray> value;
-    value.first = item->toByteArray();
-    ++item;
-
-    // 如果到了行最后，则发出 错误提示
-    if (item == rows.end()) {
-      emit m_notifier->error(QCoreApplication::translate("RDM", "Data was loaded from server partially."));
-      return 0;
-    }
-
-    value.second = item->toByteArray();
-    result.push_back(value);
+int HashKeyModel::addLoadedRowsToCache(const QVariantList &rows, QVariant rowStartId, RowsCache &target) {
+  // 如果到了行最后，则发出 错误提示
+  if (rows.size() % 2 != 0) {
+    emit m_notifier->error(QCoreApplication::translate("RDM", "Data was loaded from server partially."));
+    return 0;
+  }
+
+  int payload = 0;
+  for (const QVariant& item : rows) { payload += item.toByteArray().size(); }
+
+  PairColumnPage page;
+  page.reserve(rows.size() / 2, payload);
+
+  for (int item = 0; item < rows.size(); item += 2) {
+    QByteArray field = rows.at(item).toByteArray();
+    QByteArray value = rows.at(item + 1).toByteArray();
+    page.append(field.constData(), field.size(), value.constData(), value.size());
   }
 
   auto rowStart = rowStartId.toLongLong();
-  m_rowsCache.addLoadedRange({rowStart, rowStart + result.size() - 1}, result);
+  int added = page.size();
+  target.addLoadedPage({rowStart, rowStart + added - 1}, page);
 
-  return result.size();
+  return added;
 }
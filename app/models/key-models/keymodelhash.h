@@ -3,7 +3,7 @@
 
 
 
-class HashKeyModel : public KeyModel<QPair<QByteArray, QByteArray>> {
+class HashKeyModel : public KeyModel<QPair<QByteArray, QByteArray>, PairColumnPage> {
  public:
   HashKeyModel(QSharedPointer<RedisClient::Connection> connection, QByteArray fullPath, int dbIndex, long long ttl);
 
@@ -18,7 +18,7 @@ class HashKeyModel : public KeyModel<QPair<QByteArray, QByteArray>> {
   void removeRow(int, Callback) override;
 
  protected:
-  int addLoadedRowsToCache(const QVariantList &list, QVariant rowStart) override;
+  int addLoadedRowsToCache(const QVariantList &list, QVariant rowStart, RowsCache &target) override;
 
  private:
   enum Roles { RowNumber = Qt::UserRole + 1, Key, Value };
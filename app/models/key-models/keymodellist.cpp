@@ -1,10 +1,96 @@
 #include "keymodellist.h"
 #include "connection.h"
+#include "app/models/luascript.h"
+#include <cctype>
 
 
 
 const static QByteArray LIST_ITEM_REMOVAL_STUB("---VALUE_REMOVED_BY_RDM---");
 
+// Elements checked by one script call, keeps server blocked for a short time only
+const static long long LIST_SEARCH_CHUNK = 1000;
+
+// Filters one chunk of list on server. Returns start of the next chunk (0 after
+// the last one), flat list of positions and values of matching elements and
+// list length at the time of the chunk.
+const static QByteArray LIST_SEARCH_SCRIPT = R"lua(
+local start = tonumber(ARGV[1])
+local chunk = tonumber(ARGV[2])
+local items = redis.call('LRANGE', KEYS[1], start, start + chunk - 1)
+local matches = {}
+for i, item in ipairs(items) do
+  if string.find(item, ARGV[3]) then
+    matches[#matches + 1] = start + i - 1
+    matches[#matches + 1] = item
+  end
+end
+local nextStart = start + #items
+if #items < chunk then nextStart = 0 end
+return {nextStart, matches, redis.call('LLEN', KEYS[1])}
+)lua";
+
+namespace {
+    QByteArray luaEscaped(char c) {
+        if (c == '\0') { return "%z"; }
+        if (std::isalnum(static_cast<unsigned char>(c)) || static_cast<unsigned char>(c) >= 0x80) {
+            return QByteArray(1, c);
+        }
+        return QByteArray(1, '%') + c;
+    }
+
+    // Converts redis glob pattern (same as MATCH of SCAN commands) into anchored lua pattern
+    QByteArray globToLuaPattern(const QByteArray& glob) {
+        QByteArray pattern("^");
+
+        for (int i = 0; i < glob.size(); ++i) {
+            char c = glob.at(i);
+            switch (c) {
+            case '*':
+                pattern += ".*";
+                break;
+            case '?':
+                pattern += '.';
+                break;
+            case '\\':
+                if (i + 1 < glob.size()) { ++i; }
+                pattern += luaEscaped(glob.at(i));
+                break;
+            case '[': {
+                int j = i + 1;
+                bool negate = j < glob.size() && glob.at(j) == '^';
+                if (negate) { ++j; }
+
+                // NOTE: like in redis, unterminated set runs to the end of pattern
+                QByteArray members;
+                for (; j < glob.size() && glob.at(j) != ']'; ++j) {
+                    char m = glob.at(j);
+                    if (m == '\\' && j + 1 < glob.size()) {
+                        members += luaEscaped(glob.at(++j));
+                    } else if (m == '-' && !members.isEmpty() && j + 1 < glob.size() && glob.at(j + 1) != ']') {
+                        members += '-';
+                    } else {
+                        members += luaEscaped(m);
+                    }
+                }
+                i = j;
+
+                if (members.isEmpty()) {
+                    // Empty set matches nothing, negated empty set matches any char
+                    pattern += negate ? QByteArray(".") : QByteArray("[^%z\x01-\xff]");
+                } else {
+                    pattern += '[' + QByteArray(negate ? "^" : "") + members + ']';
+                }
+                break;
+            }
+            default:
+                pattern += luaEscaped(c);
+            }
+        }
+
+        return pattern + '$';
+    }
+}
+
 ListKeyModel::ListKeyModel(QSharedPointer<RedisClient::Connection> connection, QByteArray fullPath, int dbIndex, long long ttl) : ListLikeKeyModel(connection, fullPath, dbIndex, ttl, "LLEN", "LRANGE") {}
 
 QString ListKeyModel::type() { return "list"; }
@@ -101,15 +187,68 @@ QList<QByteArray> ListKeyModel::getRangeCmd(QVariant rowStartId, unsigned long c
 
 
 
-int ListKeyModel::addLoadedRowsToCache(const QVariantList &rows, QVariant rowStartId) {
-  if (isReverseOrder()) {
-    return ListLikeKeyModel::addLoadedRowsToCache(QList<QVariant>(rows.rbegin(), rows.rend()), rowStartId);
+int ListKeyModel::addLoadedRowsToCache(const QVariantList &rows, QVariant rowStartId, RowsCache &target) {
+  // NOTE: search results are kept in order of positions in list
+  if (isReverseOrder() && &target == &m_rowsCache) {
+    return ListLikeKeyModel::addLoadedRowsToCache(QList<QVariant>(rows.rbegin(), rows.rend()), rowStartId, target);
   } else {
-    return ListLikeKeyModel::addLoadedRowsToCache(rows, rowStartId);
+    return ListLikeKeyModel::addLoadedRowsToCache(rows, rowStartId, target);
   }
 }
 
 
+void ListKeyModel::searchRows(const QByteArray &pattern, SearchCallback progress) {
+  cancelSearch();
+  searchChunk(globToLuaPattern(pattern), 0, m_searchGeneration, progress);
+}
+
+void ListKeyModel::searchChunk(const QByteArray &luaPattern, long long start, quint64 generation, SearchCallback progress) {
+  static const LuaScript searchScript(LIST_SEARCH_SCRIPT);
+
+  int db = -1;
+  auto connection = scriptConnection(db);
+  auto self = ValueEditor::Model::sharedFromThis().toWeakRef();
+
+  searchScript.eval(connection.data(), {m_keyFullPath},
+                    {QByteArray::number(start), QByteArray::number(LIST_SEARCH_CHUNK), luaPattern},
+                    m_notifier.data(), db,
+                    [this, self, luaPattern, generation, progress](RedisClient::Response r, QString err) {
+    if (!self || generation != m_searchGeneration) { return; }
+
+    QVariantList result = r.value().toList();
+    if (err.isEmpty() && result.size() != 3) {
+      err = QCoreApplication::translate("RDM", "Server returned unexpected response: ") + r.value().toString();
+    }
+    if (!err.isEmpty()) { return progress(err, m_searchRowsCount, true); }
+
+    QVariantList matches = result.at(1).toList();
+    long long length = result.at(2).toLongLong();
+    QVariantList values;
+    QVector<RowIndex> positions;
+    values.reserve(matches.size() / 2);
+    positions.reserve(matches.size() / 2);
+
+    for (int item = 0; item + 1 < matches.size(); item += 2) {
+      // NOTE: view shows reversed list, rows are counted from the tail
+      long long position = matches.at(item).toLongLong();
+      positions.append(isReverseOrder() ? length - 1 - position : position);
+      values.append(matches.at(item + 1));
+    }
+    addSearchResults(values, positions);
+
+    long long nextStart = result.at(0).toLongLong();
+    if (nextStart == 0) { return progress(QString(), m_searchRowsCount, true); }
+
+    if (m_searchCache.memoryUsage() >= RowCacheBudget::modelLimit()) {
+      return progress(QCoreApplication::translate("RDM", "Row cache limit is reached, only part of matching rows is loaded"), m_searchRowsCount, true);
+    }
+
+    progress(QString(), m_searchRowsCount, false);
+    searchChunk(luaPattern, nextStart, generation, progress);
+  });
+}
+
+
 
 
 void ListKeyModel::verifyListItemPosition(int row, Callback c) {
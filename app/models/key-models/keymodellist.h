@@ -11,12 +11,17 @@ public:
     void addRow(const QVariantMap &, ValueEditor::Model::Callback c) override;
     void removeRow(int, ValueEditor::Model::Callback c) override;
 
+    // Lists have no MATCH command, list is filtered by lua script chunk by chunk
+    void searchRows(const QByteArray& pattern, SearchCallback progress) override;
+
 protected:
     virtual QList<QByteArray> getRangeCmd(QVariant rowStartId, unsigned long count) override;
 
-    int addLoadedRowsToCache(const QVariantList& rows, QVariant rowStart) override;
+    int addLoadedRowsToCache(const QVariantList& rows, QVariant rowStart, RowsCache& target) override;
 
  private:
+    void searchChunk(const QByteArray& luaPattern, long long start, quint64 generation, SearchCallback progress);
+
     void verifyListItemPosition(int row, Callback c);
     void addListRow(const QByteArray &value, Callback c);
     void setListRow(int pos, const QByteArray &value, Callback c);
@@ -28,14 +28,15 @@ QVariant ListLikeKeyModel::getData(int rowIndex, int dataRole) {
 }
 
 
-int ListLikeKeyModel::addLoadedRowsToCache(const QVariantList &rows, QVariant rowStartId) {
+int ListLikeKeyModel::addLoadedRowsToCache(const QVariantList &rows, QVariant rowStartId, RowsCache &target) {
   QList<QByteArray> result;
   auto rowStart = rowStartId.toLongLong();
+  result.reserve(rows.size());
 
-  foreach (QVariant row, rows) {
+  for (const QVariant& row : rows) {
       result.push_back(row.toByteArray());
   }
 
-  m_rowsCache.addLoadedRange({rowStart, rowStart + result.size() - 1}, result);
+  target.addLoadedRange({rowStart, rowStart + result.size() - 1}, result);
   return result.size();
 }
@@ -14,5 +14,5 @@ protected:
     enum Roles { RowNumber = Qt::UserRole + 1, Value };
 
 protected:
-    int addLoadedRowsToCache(const QVariantList& rows, QVariant rowStart) override;
+    int addLoadedRowsToCache(const QVariantList& rows, QVariant rowStart, RowsCache& target) override;
 };
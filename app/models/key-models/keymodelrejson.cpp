@@ -66,7 +66,7 @@ void ReJSONKeyModel::loadRows(QVariant, unsigned long, LoadRowsCallback callback
     callback(QString(), 1);
   };
 
-  executeCmd({"JSON.GET", m_keyFullPath}, onConnectionError, responseHandler, RedisClient::Response::String);
+  executeReadCmd({"JSON.GET", m_keyFullPath}, onConnectionError, responseHandler, RedisClient::Response::String);
 }
 
 void ReJSONKeyModel::removeRow(int, Callback) {
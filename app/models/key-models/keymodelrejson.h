@@ -17,7 +17,7 @@ public:
     void removeRow(int, ValueEditor::Model::Callback c) override;
 
 protected:
-    int addLoadedRowsToCache(const QVariantList&, QVariant) override { return 1; }
+    int addLoadedRowsToCache(const QVariantList&, QVariant, RowsCache&) override { return 1; }
 
 private:
     enum Roles { Value = Qt::UserRole + 1 };
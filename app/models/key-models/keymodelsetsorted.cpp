@@ -1,8 +1,21 @@
 #include "keymodelsetsorted.h"
 #include "connection.h"
+#include "app/models/luascript.h"
+#include <QLocale>
 #include <QPair>
 
 
+// ZRANGEBYLEX doesn't return scores, they are added on server to keep one round trip per page
+const static QByteArray LEX_RANGE_SCRIPT = R"lua(
+local members = redis.call('ZRANGEBYLEX', KEYS[1], unpack(ARGV))
+local rows = {}
+for _, member in ipairs(members) do
+  rows[#rows + 1] = member
+  rows[#rows + 1] = redis.call('ZSCORE', KEYS[1], member)
+end
+return rows
+)lua";
+
 
 SortedSetKeyModel::SortedSetKeyModel(QSharedPointer<RedisClient::Connection> connection, QByteArray fullPath, int dbIndex, long long ttl) : KeyModel(connection, fullPath, dbIndex, ttl, "ZCARD", "ZRANGE WITHSCORES") {}
 
@@ -23,13 +36,14 @@ QStringList SortedSetKeyModel::getColumnNames() {
 
 
 QVariant SortedSetKeyModel::getData(int rowIndex, int dataRole) {
-  if (!isRowLoaded(rowIndex)) { return QVariant(); }
+  int offset = 0;
+  const ScoredColumnPage* page = m_rowsCache.pageOf(rowIndex, offset);
+  if (!page) { return QVariant(); }
 
-  QPair<QByteArray, QByteArray> row = m_rowsCache[rowIndex];
   if (dataRole == Roles::Value){
-    return row.first;
+    return page->member(offset);
   }else if (dataRole == Roles::Score){
-    return row.second.toDouble();
+    return page->score(offset);
   }else if (dataRole == Roles::RowNumber){
     return rowIndex;
   }
@@ -42,28 +56,31 @@ void SortedSetKeyModel::updateRow(int rowIndex, const QVariantMap &row, Callback
     return;
   }
 
-  QPair<QByteArray, QByteArray> cachedRow = m_rowsCache[rowIndex];
+  QPair<QByteArray, double> cachedRow = m_rowsCache[rowIndex];
 
   bool valueChanged = cachedRow.first != row["value"].toString();
-  bool scoreChanged = cachedRow.second != row["score"].toString();
+  bool scoreChanged = cachedRow.second != row["score"].toDouble();
 
   QByteArray rowvalue = (valueChanged) ? row["value"].toByteArray() : cachedRow.first;
-  QByteArray rowscore = (scoreChanged) ? row["score"].toByteArray() : cachedRow.second;
-  QPair<QByteArray, QByteArray> newRow(rowvalue, rowscore);
+  QByteArray rowscore = (scoreChanged) ? row["score"].toByteArray() : formatScore(cachedRow.second);
+  QPair<QByteArray, double> newRow(rowvalue, rowscore.toDouble());
 
   auto onRowAdded = [this, c, rowIndex, newRow](const QString &err) {
-    if (err.isEmpty()) { m_rowsCache.replace(rowIndex, newRow); }
+    if (err.isEmpty()) {
+      m_rowsCache.replace(rowIndex, newRow);
+      m_rangeCheckpoints.clear();
+    }
     return c(err);
   };
 
   if (valueChanged) {
     deleteSortedSetRow(cachedRow.first,
-                       [this, c, onRowAdded, newRow](const QString &err) {
+                       [this, c, onRowAdded, rowvalue, rowscore](const QString &err) {
                           if (err.size() > 0) return c(err);
-                          addSortedSetRow(newRow.first, newRow.second, onRowAdded, false);
+                          addSortedSetRow(rowvalue, rowscore, onRowAdded, false);
                        });
   } else {
-    addSortedSetRow(newRow.first, newRow.second, onRowAdded, true);
+    addSortedSetRow(rowvalue, rowscore, onRowAdded, true);
   }
 }
 
@@ -74,7 +91,10 @@ void SortedSetKeyModel::addRow(const QVariantMap &row, Callback c) {
   }
 
   auto onAdded = [this, c](const QString &err) {
-    if (err.isEmpty()){ m_rowCount++; }
+    if (err.isEmpty()){
+      m_rowCount++;
+      m_rangeCheckpoints.clear();
+    }
     return c(err);
   };
 
@@ -91,6 +111,7 @@ void SortedSetKeyModel::removeRow(int i, Callback c) {
                 if (err.isEmpty()) {
                   m_rowCount--;
                   m_rowsCache.removeAt(i);
+                  m_rangeCheckpoints.clear();
                   setRemovedIfEmpty();
                 }
                 return c(err);
@@ -114,26 +135,200 @@ void SortedSetKeyModel::deleteSortedSetRow(const QByteArray &value, Callback c)
 
 
 
+void SortedSetKeyModel::loadRowsCount(Callback c) {
+  RangeMode mode = rangeMode();
+  if (mode == RangeMode::Rank) {
+    return KeyModel::loadRowsCount(c);
+  }
 
-int SortedSetKeyModel::addLoadedRowsToCache(const QVariantList &rows, QVariant rowStartId) {
-  QList<QPair<QByteArray, QByteArray>> result;
+  // NOTE: only rows of window are counted, view pages through them with LIMIT
+  m_rowCountPreloaded = false;
+  executeReadCmd({mode == RangeMode::Score ? "ZCOUNT" : "ZLEXCOUNT", m_keyFullPath, rangeMin(), rangeMax()},
+                 c,
+                 [this](RedisClient::Response r, Callback c) {
+                    m_rowCount = r.value().toUInt();
+                    c(QString());
+                 },
+                 RedisClient::Response::Type::Integer);
+}
 
-  for (QVariantList::const_iterator item = rows.begin(); item != rows.end(); ++item) {
-    QPair<QByteArray, QByteArray> value;
-    value.first = item->toByteArray();
-    ++item;
+void SortedSetKeyModel::clearRowCache() {
+  m_rangeCheckpoints.clear();
+  KeyModel::clearRowCache();
+}
 
-    if (item == rows.end()) {
-      emit m_notifier->error(QCoreApplication::translate("RDM", "Data was loaded from server partially."));
-      return 0;
-    }
+void SortedSetKeyModel::setFilter(const QString &k, QVariant v) {
+  // NOTE: checkpoints continue the previous window and are wrong for a new one
+  if (k == "rangeBy" || k == "min" || k == "max") {
+    m_rangeCheckpoints.clear();
+  }
+  KeyModel::setFilter(k, v);
+
+  if (k == "jumpToScore") {
+    auto self = ValueEditor::Model::sharedFromThis().toWeakRef();
+    findScoreRow(v.toDouble(), [this, self](const QString &err, RowIndex row) {
+      if (!self) { return; }
+
+      m_filters["scoreRow"] = row;
+      m_filters["scoreRowError"] = err;
+      emit m_notifier->filtersChanged({"scoreRow", "scoreRowError"});
+    });
+  }
+}
+
+bool SortedSetKeyModel::canPrefetchPage(RowIndex start) const {
+  // NOTE: without checkpoint of the previous page LIMIT offset makes server walk
+  // over all preceding rows of window, so page waits until the previous one is loaded
+  return rangeMode() == RangeMode::Rank || m_rangeCheckpoints.contains(start);
+}
+
+void SortedSetKeyModel::findScoreRow(double score, std::function<void(const QString&, RowIndex)> callback) {
+  RangeMode mode = rangeMode();
+  if (mode == RangeMode::Lex) {
+    return callback(QCoreApplication::translate("RDM", "Rows of lexicographical range can't be found by score"), -1);
+  }
+
+  QByteArray min = mode == RangeMode::Score ? rangeMin() : QByteArray("-inf");
+  executeReadCmd({"ZCOUNT", m_keyFullPath, min, "(" + formatScore(score)},
+                 [callback](const QString &err) {
+                    if (!err.isEmpty()) { callback(err, -1); }
+                 },
+                 [callback](RedisClient::Response r, Callback) {
+                    callback(QString(), r.value().toLongLong());
+                 },
+                 RedisClient::Response::Type::Integer);
+}
+
+QList<QByteArray> SortedSetKeyModel::getRangeCmd(QVariant rowStartId, unsigned long count) {
+  RangeMode mode = rangeMode();
+  if (mode == RangeMode::Rank) {
+    return KeyModel::getRangeCmd(rowStartId, count);
+  }
+
+  // NOTE: page which follows a loaded page starts from its last row instead of
+  // LIMIT offset from window start, so server doesn't walk over preceding rows
+  RowIndex rowStart = rowStartId.toLongLong();
+  QByteArray min = rangeMin();
+  long long offset = rowStart;
+
+  auto checkpoint = m_rangeCheckpoints.constFind(rowStart);
+  if (checkpoint != m_rangeCheckpoints.constEnd()) {
+    min = checkpoint->min;
+    offset = checkpoint->offset;
+  }
+
+  QList<QByteArray> cmd;
+  if (mode == RangeMode::Score) {
+    cmd = {"ZRANGEBYSCORE", m_keyFullPath, min, rangeMax(), "WITHSCORES"};
+  } else {
+    cmd = {"ZRANGEBYLEX", m_keyFullPath, min, rangeMax()};
+  }
+  cmd << "LIMIT" << QByteArray::number(offset) << QByteArray::number(static_cast<qulonglong>(count));
+  return cmd;
+}
+
+void SortedSetKeyModel::getRowsRange(const QList<QByteArray> &rangeCmd, std::function<void(const QString &, QVariantList)> callback) {
+  if (rangeCmd.first() != "ZRANGEBYLEX") {
+    return KeyModel::getRowsRange(rangeCmd, callback);
+  }
+
+  static const LuaScript lexRangeScript(LEX_RANGE_SCRIPT);
+
+  try {
+    int db = -1;
+    lexRangeScript.eval(scriptConnection(db).data(), {m_keyFullPath}, rangeCmd.mid(2), getConnector().data(), db,
+                        [callback](RedisClient::Response r, QString err) {
+                            if (!err.isEmpty()) { return callback(err, QVariantList()); }
+                            callback(QString(), r.value().toList());
+                        });
+  } catch (const RedisClient::Connection::Exception& e) {
+    callback(QCoreApplication::translate("RDM", "Cannot load rows for key %1: %2").arg(getKeyName()).arg(e.what()), QVariantList());
+  }
+}
+
+void SortedSetKeyModel::setRemovedIfEmpty() {
+  // NOTE: empty window doesn't mean that key was removed
+  if (rangeMode() == RangeMode::Rank) {
+    KeyModel::setRemovedIfEmpty();
+  }
+}
+
+SortedSetKeyModel::RangeMode SortedSetKeyModel::rangeMode() const {
+  QString rangeBy = m_filters.value("rangeBy", "rank").toString();
+  if (rangeBy == "score") {
+    return RangeMode::Score;
+  } else if (rangeBy == "lex") {
+    return RangeMode::Lex;
+  }
+  return RangeMode::Rank;
+}
+
+QByteArray SortedSetKeyModel::rangeMin() const {
+  QByteArray defaultMin = rangeMode() == RangeMode::Lex ? "-" : "-inf";
+  return m_filters.value("min", defaultMin).toByteArray();
+}
+
+QByteArray SortedSetKeyModel::rangeMax() const {
+  QByteArray defaultMax = rangeMode() == RangeMode::Lex ? "+" : "+inf";
+  return m_filters.value("max", defaultMax).toByteArray();
+}
+
+void SortedSetKeyModel::addRangeCheckpoint(RowIndex rowStart, const ScoredColumnPage &page) {
+  int size = page.size();
+  if (size == 0) { return; }
+
+  RowIndex nextStart = rowStart + size;
+  if (rangeMode() == RangeMode::Lex) {
+    // Members are unique, next page starts right after the last one
+    m_rangeCheckpoints[nextStart] = {"(" + page.member(size - 1), 0, 0};
+    return;
+  }
+
+  // Scores are not unique, next page starts at the last score and skips rows
+  // with this score which were already loaded
+  double lastScore = page.score(size - 1);
+  long long ties = 1;
+  while (ties < size && page.score(size - 1 - ties) == lastScore) { ++ties; }
+
+  if (ties == size && rowStart > 0) {
+    auto previous = m_rangeCheckpoints.constFind(rowStart);
+    if (previous == m_rangeCheckpoints.constEnd()) { return; }
+    if (previous->score == lastScore) { ties += previous->offset; }
+  }
+
+  m_rangeCheckpoints[nextStart] = {formatScore(lastScore), ties, lastScore};
+}
+
+// Shortest representation which parses back to the same double, "inf" and "-inf" are accepted by ZADD
+QByteArray SortedSetKeyModel::formatScore(double score) {
+  return QString::number(score, 'g', QLocale::FloatingPointShortest).toLatin1();
+}
+
+
+
+
+int SortedSetKeyModel::addLoadedRowsToCache(const QVariantList &rows, QVariant rowStartId, RowsCache &target) {
+  if (rows.size() % 2 != 0) {
+    emit m_notifier->error(QCoreApplication::translate("RDM", "Data was loaded from server partially."));
+    return 0;
+  }
+
+  int payload = 0;
+  for (int item = 0; item < rows.size(); item += 2) { payload += rows.at(item).toByteArray().size(); }
+
+  // NOTE: scores are parsed once here instead of on every paint
+  ScoredColumnPage page;
+  page.reserve(rows.size() / 2, payload);
 
-    value.second = item->toByteArray();
-    result.push_back(value);
+  for (int item = 0; item < rows.size(); item += 2) {
+    QByteArray member = rows.at(item).toByteArray();
+    page.append(member.constData(), member.size(), rows.at(item + 1).toByteArray().toDouble());
   }
 
   auto rowStart = rowStartId.toLongLong();
-  m_rowsCache.addLoadedRange({rowStart, rowStart + result.size() - 1}, result);
+  int added = page.size();
+  if (&target == &m_rowsCache) { addRangeCheckpoint(rowStart, page); }
+  target.addLoadedPage({rowStart, rowStart + added - 1}, page);
 
-  return result.size();
+  return added;
 }
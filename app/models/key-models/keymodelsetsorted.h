@@ -1,7 +1,7 @@
 #pragma once
 #include "abstractkeymodel.h"
 
-class SortedSetKeyModel : public KeyModel<QPair<QByteArray, QByteArray>> {
+class SortedSetKeyModel : public KeyModel<QPair<QByteArray, double>, ScoredColumnPage> {
 public:
     SortedSetKeyModel(QSharedPointer<RedisClient::Connection> connection, QByteArray fullPath, int dbIndex, long long ttl);
 
@@ -15,12 +15,48 @@ public:
     void addRow(const QVariantMap&, Callback c) override;
     void removeRow(int, Callback c) override;
 
+    // Filter "rangeBy" switches view from ranks to a score ("score") or lexicographical ("lex")
+    // window between filters "min" and "max", bounds use ZRANGEBYSCORE/ZRANGEBYLEX syntax
+    void loadRowsCount(Callback c) override;
+    void clearRowCache() override;
+
 protected:
-    int addLoadedRowsToCache(const QVariantList& list, QVariant rowStart) override;
+    // Row of the first member with score >= score, in score window row is counted from window start.
+    // Started by view with "jumpToScore" filter, result is published in "scoreRow" and "scoreRowError" filters
+    void findScoreRow(double score, std::function<void(const QString& err, RowIndex row)> callback);
+
+    QList<QByteArray> getRangeCmd(QVariant rowStartId, unsigned long count) override;
+    void getRowsRange(const QList<QByteArray>& rangeCmd, std::function<void(const QString&, QVariantList)> callback) override;
+    void setRemovedIfEmpty() override;
+
+    void setFilter(const QString& k, QVariant v) override;
+
+    bool canPrefetchPage(RowIndex start) const override;
+
+    QByteArray searchScanCmd() const override { return "ZSCAN"; }
+
+    int addLoadedRowsToCache(const QVariantList& list, QVariant rowStart, RowsCache& target) override;
 
 private:
     enum Roles { RowNumber = Qt::UserRole + 1, Value, Score };
 
     void addSortedSetRow(const QByteArray& value, QByteArray score, Callback c, bool updateExisting = false);
     void deleteSortedSetRow(const QByteArray& value, Callback c);
+
+    static QByteArray formatScore(double score);
+
+    enum class RangeMode { Rank, Score, Lex };
+    RangeMode rangeMode() const;
+    QByteArray rangeMin() const;
+    QByteArray rangeMax() const;
+
+    void addRangeCheckpoint(RowIndex rowStart, const ScoredColumnPage& page);
+
+    // Bound and LIMIT offset which continue window right after the row before checkpoint
+    struct RangeCheckpoint {
+        QByteArray min;
+        long long offset;
+        double score;
+    };
+    QHash<RowIndex, RangeCheckpoint> m_rangeCheckpoints;
 };
@@ -0,0 +1,15 @@
+#pragma once
+#include <QStringList>
+#include "modules/value-editor/keymodel.h"
+
+
+// Model signals of key models.
+// Values which model publishes in filters on its own (fill and search progress,
+// stream first/last entry) are announced with filtersChanged(), view reads them
+// with Model::filter() instead of polling.
+class KeyModelSignals : public ValueEditor::ModelSignals {
+  Q_OBJECT
+
+ signals:
+  void filtersChanged(const QStringList& keys);
+};
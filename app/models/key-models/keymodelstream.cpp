@@ -1,7 +1,10 @@
 #include "keymodelstream.h"
 #include <QJsonDocument>
 
-StreamKeyModel::StreamKeyModel(QSharedPointer<RedisClient::Connection> connection, QByteArray fullPath, int dbIndex, long long ttl): KeyModel(connection, fullPath, dbIndex, ttl, "XLEN", QByteArray()) {}
+StreamKeyModel::StreamKeyModel(QSharedPointer<RedisClient::Connection> connection, QByteArray fullPath, int dbIndex, long long ttl): KeyModel(connection, fullPath, dbIndex, ttl, "XLEN", QByteArray()) {
+  // NOTE: pages are loaded relative to the last ID of previous page, so they can't be evicted
+  m_rowsCache.setEvictable(false);
+}
 
 QString StreamKeyModel::type() { return "stream"; }
 
@@ -73,7 +76,7 @@ void StreamKeyModel::removeRow(int i, ValueEditor::Model::Callback c) {
 
 
 void StreamKeyModel::loadRowsCount(ValueEditor::Model::Callback c) {
-  executeCmd({"XINFO", "STREAM", m_keyFullPath},
+  executeReadCmd({"XINFO", "STREAM", m_keyFullPath},
              c,
              [this](RedisClient::Response r, Callback c) {
                 auto info = r.value().toList();
@@ -94,6 +97,7 @@ void StreamKeyModel::loadRowsCount(ValueEditor::Model::Callback c) {
                     auto list = it->toList();
                     if (list.size() > 0) {
                       m_filters[QString::fromLatin1(propertyName)] = list[0];
+                      emit m_notifier->filtersChanged({QString::fromLatin1(propertyName)});
                     }
                   }
                   it++;
@@ -106,7 +110,7 @@ void StreamKeyModel::loadRowsCount(ValueEditor::Model::Callback c) {
 
 
 
-int StreamKeyModel::addLoadedRowsToCache(const QVariantList &rows, QVariant rowStartId) {
+int StreamKeyModel::addLoadedRowsToCache(const QVariantList &rows, QVariant rowStartId, RowsCache &target) {
   QList<QPair<QByteArray, QVariant>> result;
 
   for (QVariantList::const_iterator item = rows.begin(); item != rows.end(); ++item) {
@@ -130,7 +134,7 @@ int StreamKeyModel::addLoadedRowsToCache(const QVariantList &rows, QVariant rowS
   }
 
   auto rowStart = rowStartId.toLongLong();
-  m_rowsCache.addLoadedRange({rowStart, rowStart + result.size() - 1}, result);
+  target.addLoadedRange({rowStart, rowStart + result.size() - 1}, result);
 
   return result.size();
 }
@@ -19,9 +19,12 @@ public:
     void loadRowsCount(ValueEditor::Model::Callback c) override;
 
 protected:
-    int addLoadedRowsToCache(const QVariantList &list, QVariant rowStart) override;
+    int addLoadedRowsToCache(const QVariantList &list, QVariant rowStart, RowsCache &target) override;
     virtual QList<QByteArray> getRangeCmd(QVariant rowStartId, unsigned long count) override;
 
+    // Pages are ranges of IDs which continue the previous page
+    bool canPrefetchRows() const override { return false; }
+
 protected:
     enum Roles { RowNumber = Qt::UserRole + 1, ID, Value };
 };
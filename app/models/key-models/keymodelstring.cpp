@@ -73,7 +73,7 @@ void StringKeyModel::loadRows(QVariant, unsigned long, LoadRowsCallback callback
 
     // Detect HyperLogLog
     if (value.startsWith("HYLL")) {
-      executeCmd({"PFCOUNT", m_keyFullPath}, 
+      executeReadCmd({"PFCOUNT", m_keyFullPath}, 
                  [callback](const QString&) {
                     callback(QString(), 1);
                  },
@@ -88,7 +88,7 @@ void StringKeyModel::loadRows(QVariant, unsigned long, LoadRowsCallback callback
     }
   };
 
-  executeCmd({"GET", m_keyFullPath}, onConnectionError, responseHandler, RedisClient::Response::String);
+  executeReadCmd({"GET", m_keyFullPath}, onConnectionError, responseHandler, RedisClient::Response::String);
 }
 
 void StringKeyModel::removeRow(int, Callback) {
@@ -21,7 +21,7 @@ public:
     virtual unsigned long rowsCount() override { return m_rowCount; }
 
 protected:
-    int addLoadedRowsToCache(const QVariantList&, QVariant) override { return 1; }
+    int addLoadedRowsToCache(const QVariantList&, QVariant, RowsCache&) override { return 1; }
 
 private:
     enum Roles { Value = Qt::UserRole + 1 };
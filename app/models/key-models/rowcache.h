@@ -1,59 +1,264 @@
 #pragma once
 #include <QHash>
 #include <QList>
+#include <QMap>
 #include <QPair>
+#include <QVariant>
+#include <atomic>
 #include <exception>
 #include <iostream>
+#include <limits>
+#include <list>
 
 typedef qlonglong RowIndex;
 
 
+// Approximate heap footprint of cached rows, used for cache budgets
+inline qulonglong rowByteSize(const QByteArray& row) {
+    return sizeof(QByteArray) + sizeof(QArrayData) + row.capacity();
+}
+
+inline qulonglong rowByteSize(const QVariant& row) {
+    switch (row.type()) {
+    case QVariant::ByteArray:
+        return sizeof(QVariant) + rowByteSize(row.toByteArray());
+    case QVariant::String:
+        return sizeof(QVariant) + sizeof(QArrayData) + row.toString().capacity() * sizeof(QChar);
+    case QVariant::List: {
+        qulonglong bytes = sizeof(QVariant);
+        for (const QVariant& item : row.toList()) { bytes += sizeof(void*) + rowByteSize(item); }
+        return bytes;
+    }
+    case QVariant::Map: {
+        qulonglong bytes = sizeof(QVariant);
+        QVariantMap map = row.toMap();
+        for (auto i = map.constBegin(); i != map.constEnd(); ++i) {
+            bytes += sizeof(void*) * 3 + rowByteSize(i.value()) + sizeof(QArrayData) + i.key().capacity() * sizeof(QChar);
+        }
+        return bytes;
+    }
+    default:
+        return sizeof(QVariant);
+    }
+}
+
+template <typename F, typename S>
+inline qulonglong rowByteSize(const QPair<F, S>& row) {
+    return rowByteSize(row.first) + rowByteSize(row.second);
+}
+
+
 class CacheRange : public QPair<RowIndex, RowIndex> {
 public:
     CacheRange(const RowIndex& f = -1, const RowIndex& s = -1) : QPair<RowIndex, RowIndex>(f, s) {}
     bool isEmpty() const { return first == -1 && second == -1; }
+    bool contains(RowIndex index) const { return first <= index && index <= second; }
+};
+
+
+// Memory limits shared by all row caches. A cache which goes over its own
+// limit evicts its least recently used pages, a cache which pushes the total
+// over the global one evicts least recently used pages of all caches.
+// NOTE: pages of all models are tracked in one list, row caches are used from GUI thread only
+class RowCacheBudget {
+public:
+    static const qulonglong DEFAULT_MODEL_LIMIT = 256ull * 1024 * 1024;
+    static const qulonglong DEFAULT_GLOBAL_LIMIT = 1024ull * 1024 * 1024;
+
+    // Cache which drops its pages when budget asks for it
+    class Owner {
+    public:
+        virtual ~Owner() {}
+        virtual void evictPage(const CacheRange& range) = 0;
+    };
+
+    struct TrackedPage {
+        Owner* owner;
+        CacheRange range;
+    };
+    typedef std::list<TrackedPage> PageList;
+
+    static void setLimits(qulonglong modelLimit, qulonglong globalLimit) {
+        s_modelLimit = modelLimit;
+        s_globalLimit = globalLimit;
+    }
+
+    static qulonglong modelLimit() { return s_modelLimit; }
+    static qulonglong globalLimit() { return s_globalLimit; }
+    static qulonglong globalUsage() { return s_globalUsage; }
+
+    static void acquire(qulonglong bytes) { s_globalUsage += bytes; }
+    static void release(qulonglong bytes) { s_globalUsage -= bytes; }
+
+    // Evictable pages of all caches, least recently used first
+    static PageList::iterator track(Owner* owner, const CacheRange& range) {
+        return s_pages.insert(s_pages.end(), TrackedPage{owner, range});
+    }
+    static void touch(PageList::iterator page) { s_pages.splice(s_pages.end(), s_pages, page); }
+    static void untrack(PageList::iterator page) { s_pages.erase(page); }
+
+    // Evicts least recently used pages of any cache until total usage fits global limit,
+    // the most recently used page is kept
+    static void evictGlobal() {
+        while (s_globalUsage > s_globalLimit && s_pages.size() > 1) {
+            TrackedPage oldest = s_pages.front();
+            size_t tracked = s_pages.size();
+            oldest.owner->evictPage(oldest.range);
+
+            // NOTE: page unknown to its owner is forgotten, otherwise loop would never end
+            if (s_pages.size() == tracked) { s_pages.pop_front(); }
+        }
+    }
+
+private:
+    inline static std::atomic<qulonglong> s_modelLimit{DEFAULT_MODEL_LIMIT};
+    inline static std::atomic<qulonglong> s_globalLimit{DEFAULT_GLOBAL_LIMIT};
+    inline static std::atomic<qulonglong> s_globalUsage{0};
+    inline static PageList s_pages;
 };
 
 
+// Default page storage, rows are kept as they are
 template <typename T>
-class MappedCache {
+class RowListPage {
 public:
-    MappedCache() : m_valid(false) {}
+    typedef const T& Row;
+
+    RowListPage() : m_bytes(0) {}
+    explicit RowListPage(const QList<T>& rows) : m_rows(rows), m_bytes(0) {
+        for (const T& row : rows) { m_bytes += sizeof(void*) + rowByteSize(row); }
+    }
+
+    int size() const { return m_rows.size(); }
+    Row at(int i) const { return m_rows.at(i); }
+
+    void replace(int i, const T& row) {
+        m_bytes = m_bytes - rowByteSize(m_rows.at(i)) + rowByteSize(row);
+        m_rows.replace(i, row);
+    }
+
+    void removeAt(int i) {
+        m_bytes -= sizeof(void*) + rowByteSize(m_rows.at(i));
+        m_rows.removeAt(i);
+    }
+
+    void append(const T& row) {
+        m_bytes += sizeof(void*) + rowByteSize(row);
+        m_rows.append(row);
+    }
+
+    qulonglong bytes() const { return m_bytes; }
+
+private:
+    QList<T> m_rows;
+    qulonglong m_bytes;
+};
+
+
+// Loaded pages are kept disjoint and ordered by their first row, so the page
+// holding a row is found with a single QMap::upperBound() lookup. The last hit
+// page is remembered because views read the same page cell by cell.
+// Pages are evicted as a whole, evicted rows are simply reported as not
+// loaded so the view requests them again through loadRows().
+// Page is the storage of one loaded range, models with fixed row layout use
+// columnar pages (see columnpages.h) instead of a list of rows.
+template <typename T, typename Page = RowListPage<T>>
+class MappedCache : public RowCacheBudget::Owner {
+    struct Entry {
+        Page page;
+        bool tracked = false;
+        RowCacheBudget::PageList::iterator globalPage{};
+        typename std::list<CacheRange>::iterator localPage{};
+    };
+    typedef QMap<CacheRange, Entry> Mapping;
+
+public:
+    typedef typename Page::Row Row;
+
+    MappedCache() : m_valid(false), m_hasLastHit(false), m_bytes(0), m_evictable(true) {}
+
+    // NOTE: pages are tracked by address of cache, copies would share pages and bytes of budget
+    MappedCache(const MappedCache&) = delete;
+    MappedCache& operator=(const MappedCache&) = delete;
+
+    ~MappedCache() { clear(); }
+
     bool isValid() const { return m_valid; }
+
+    // Approximate number of bytes held by loaded rows
+    qulonglong memoryUsage() const { return m_bytes; }
+
+    void setEvictable(bool evictable) { m_evictable = evictable; }
+
     void addLoadedRange(const CacheRange& range, const QList<T>& dataForRange) {
+        if (dataForRange.isEmpty()) {
+            if (!isValid()){ clear(); }
+            return;
+        }
+        addLoadedPage(range, Page(dataForRange));
+    }
+
+    void addLoadedPage(const CacheRange& range, Page page) {
         if (!isValid()){ clear(); }
-        m_mapping[range] = dataForRange;
+        if (page.size() == 0) { return; }
+
+        // NOTE: reloaded pages supersede any stale page they overlap
+        m_hasLastHit = false;
+        auto i = m_mapping.upperBound(CacheRange(range.second, std::numeric_limits<RowIndex>::max()));
+        while (i != m_mapping.begin()) {
+            --i;
+            if (i.key().second < range.first) { break; }
+            releaseBytes(i.value().page.bytes());
+            untrackPage(i.value());
+            i = m_mapping.erase(i);
+        }
+
+        acquireBytes(page.bytes());
+        auto inserted = m_mapping.insert(range, Entry{std::move(page)});
+        trackPage(inserted.value(), range);
+        evict();
     }
 
-    bool isRowLoaded(RowIndex index) {
-        CacheRange i = findTargetRange(index);
-        return !i.isEmpty();
+    bool isRowLoaded(RowIndex index) const {
+        return findTargetRange(index) != m_mapping.constEnd();
     }
 
-    T getRow(RowIndex index) {
-        if (!isRowLoaded(index)) { return T();}
+    Row getRow(RowIndex index) const {
+        static const T emptyRow = T();
+
+        auto i = findTargetRange(index);
+        if (i == m_mapping.constEnd()) { return emptyRow; }
 
-        CacheRange i = findTargetRange(index);
-        return m_mapping[i].at(index - i.first);
+        return i.value().page.at(index - i.key().first);
     }
 
-    T operator[](RowIndex index) { return getRow(index); }
+    Row operator[](RowIndex index) const { return getRow(index); }
+
+    // Page which holds row and position of row in it, nullptr if row is not loaded
+    const Page* pageOf(RowIndex index, int& offset) const {
+        auto i = findTargetRange(index);
+        if (i == m_mapping.constEnd()) { return nullptr; }
+
+        offset = static_cast<int>(index - i.key().first);
+        return &i.value().page;
+    }
 
     void replace(RowIndex index, T row) {
-        if (!isRowLoaded(index)) {
-            throw std::out_of_range("Invalid row");
-        }
-        CacheRange i = findTargetRange(index);
-        return m_mapping[i].replace(index - i.first, row);
+        CacheRange i = findPage(index).key();
+        Page& page = mutablePage(i);
+
+        qulonglong oldBytes = page.bytes();
+        page.replace(index - i.first, row);
+        updateBytes(oldBytes, page.bytes());
     }
 
     void removeAt(RowIndex index) {
-        if (!isRowLoaded(index)) {
-            throw std::out_of_range("Invalid row");
-        }
-        CacheRange i = findTargetRange(index);
+        CacheRange i = findPage(index).key();
+        Page& page = mutablePage(i);
 
-        m_mapping[i].removeAt(index - i.first);
+        qulonglong oldBytes = page.bytes();
+        page.removeAt(index - i.first);
+        updateBytes(oldBytes, page.bytes());
         CacheRange newKey{i.first, i.second - 1};
         replaceRangeInMapping(newKey, i);
         m_valid = false;
@@ -61,49 +266,159 @@ public:
 
     void push_back(const T& row) {
         CacheRange newKey{0, 1};
+        m_hasLastHit = false;
 
         if (m_mapping.size() > 0) {
             newKey.first += m_mapping.lastKey().first;
             newKey.second += m_mapping.lastKey().second;
 
-            m_mapping.last().push_back(row);
+            Page& page = m_mapping.last().page;
+            qulonglong oldBytes = page.bytes();
+            page.append(row);
+            updateBytes(oldBytes, page.bytes());
             replaceRangeInMapping(newKey);
         } else {
-            m_mapping.insert(newKey, QList<T>{row});
+            Entry entry{Page(QList<T>{row})};
+            acquireBytes(entry.page.bytes());
+            auto inserted = m_mapping.insert(CacheRange{0, 0}, entry);
+            trackPage(inserted.value(), CacheRange{0, 0});
         }
     }
 
     unsigned long long size() const {
         unsigned long long cacheSize = 0;
-        for (auto cachePage : m_mapping) {
-            cacheSize += cachePage.size();
+        for (auto cachePage = m_mapping.constBegin(); cachePage != m_mapping.constEnd(); ++cachePage) {
+            cacheSize += cachePage.value().page.size();
         }
         return cacheSize;
     }
 
     void clear() {
+        for (const Entry& entry : m_mapping) { untrackPage(entry); }
         m_mapping.clear();
+        m_hasLastHit = false;
         m_valid = true;
+        releaseBytes(m_bytes);
+    }
+
+    // Called by RowCacheBudget when pages of other caches need memory
+    void evictPage(const CacheRange& range) override {
+        auto i = m_mapping.find(range);
+        if (i == m_mapping.end()) { return; }
+
+        m_hasLastHit = false;
+        releaseBytes(i.value().page.bytes());
+        untrackPage(i.value());
+        m_mapping.erase(i);
     }
 
 private:
-    CacheRange findTargetRange(RowIndex index) {
-        for (auto i = m_mapping.constBegin(); i != m_mapping.constEnd(); ++i) {
-            if (i.key().first <= index && index <= i.key().second) {
-                return i.key();
-            }
+    typename Mapping::const_iterator findTargetRange(RowIndex index) const {
+        if (m_hasLastHit && m_lastHit.key().contains(index)) {
+            touchPage(m_lastHit.value());
+            return m_lastHit;
+        }
+
+        // Last page which starts at or before index
+        auto i = m_mapping.upperBound(CacheRange(index, std::numeric_limits<RowIndex>::max()));
+        if (i == m_mapping.constBegin()) { return m_mapping.constEnd(); }
+
+        --i;
+        if (!i.key().contains(index)) { return m_mapping.constEnd(); }
+
+        touchPage(i.value());
+        m_lastHit = i;
+        m_hasLastHit = true;
+        return i;
+    }
+
+    // NOTE: non-const access may detach mapping, remembered iterator would point into old data
+    Page& mutablePage(const CacheRange& range) {
+        m_hasLastHit = false;
+        return m_mapping[range].page;
+    }
+
+    typename Mapping::const_iterator findPage(RowIndex index) const {
+        auto i = findTargetRange(index);
+        if (i == m_mapping.constEnd()) {
+            throw std::out_of_range("Invalid row");
         }
-        return CacheRange();
+        return i;
     }
 
     void replaceRangeInMapping(const CacheRange& newRange, const CacheRange& current = CacheRange()) {
         CacheRange replaceKey = current.isEmpty() ? m_mapping.lastKey() : current;
 
-        m_mapping[newRange] = m_mapping[replaceKey];
-        m_mapping.remove(replaceKey);
+        Entry entry = m_mapping.take(replaceKey);
+        m_hasLastHit = false;
+        if (newRange.second >= newRange.first) {
+            if (entry.tracked) {
+                entry.globalPage->range = newRange;
+                *entry.localPage = newRange;
+            }
+            m_mapping.insert(newRange, entry);
+        } else {
+            releaseBytes(entry.page.bytes());
+            untrackPage(entry);
+        }
    }
 
+    // Pages of evictable caches are kept in LRU order, in this cache and across all caches
+    void trackPage(Entry& entry, const CacheRange& range) {
+        if (!m_evictable) { return; }
+
+        entry.tracked = true;
+        entry.globalPage = RowCacheBudget::track(this, range);
+        entry.localPage = m_lru.insert(m_lru.end(), range);
+    }
+
+    void untrackPage(const Entry& entry) {
+        if (!entry.tracked) { return; }
+
+        RowCacheBudget::untrack(entry.globalPage);
+        m_lru.erase(entry.localPage);
+    }
+
+    void touchPage(const Entry& entry) const {
+        if (!entry.tracked) { return; }
+
+        RowCacheBudget::touch(entry.globalPage);
+        m_lru.splice(m_lru.end(), m_lru, entry.localPage);
+    }
+
+    // Drops least recently used pages, the page which was just loaded is the most recent one and is kept
+    void evict() {
+        while (m_evictable && m_lru.size() > 1 && m_bytes > RowCacheBudget::modelLimit()) {
+            CacheRange oldest = m_lru.front();
+            evictPage(oldest);
+        }
+        RowCacheBudget::evictGlobal();
+    }
+
+    void updateBytes(qulonglong oldBytes, qulonglong newBytes) {
+        if (newBytes > oldBytes) {
+            acquireBytes(newBytes - oldBytes);
+        } else {
+            releaseBytes(oldBytes - newBytes);
+        }
+    }
+
+    void acquireBytes(qulonglong bytes) {
+        m_bytes += bytes;
+        RowCacheBudget::acquire(bytes);
+    }
+
+    void releaseBytes(qulonglong bytes) {
+        m_bytes -= bytes;
+        RowCacheBudget::release(bytes);
+    }
+
 private:
-    QMap<CacheRange, QList<T>> m_mapping;
+    Mapping m_mapping;
     bool m_valid;
+    mutable typename Mapping::const_iterator m_lastHit;
+    mutable bool m_hasLastHit;
+    qulonglong m_bytes;
+    bool m_evictable;
+    mutable std::list<CacheRange> m_lru;
 };
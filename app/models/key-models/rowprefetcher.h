@@ -0,0 +1,82 @@
+#pragma once
+#include <QElapsedTimer>
+#include <QList>
+#include <QtGlobal>
+#include "rowcache.h"
+
+
+// Predicts which rows view will request next.
+// Scroll direction and velocity are taken from consecutive page requests,
+// one page ahead is loaded when scrolling slowly and two when scrolling
+// faster than FAST_SCROLL_PAGES pages per second. A jump over more than
+// JUMP_PAGES pages (scrollbar drag) starts a new generation, results of
+// prefetches issued before the jump are dropped.
+class RowPrefetcher {
+public:
+    static const int MAX_PAGES_AHEAD = 2;
+    static const int JUMP_PAGES = 4;
+    static const int FAST_SCROLL_PAGES = 2;
+
+    RowPrefetcher() : m_lastStart(-1), m_direction(0), m_velocity(0), m_generation(0) {}
+
+    void visit(RowIndex start, RowIndex count) {
+        if (m_lastStart < 0 || !m_timer.isValid()) {
+            m_direction = 1;
+        } else {
+            RowIndex distance = start - m_lastStart;
+            qint64 elapsed = qMax<qint64>(1, m_timer.elapsed());
+
+            if (qAbs(distance) > JUMP_PAGES * count) {
+                ++m_generation;
+                m_velocity = 0;
+            } else if (distance != 0) {
+                double velocity = qAbs(distance) * 1000.0 / elapsed;
+                m_velocity = m_velocity > 0 ? (m_velocity + velocity) / 2 : velocity;
+            }
+            if (distance != 0) { m_direction = distance > 0 ? 1 : -1; }
+        }
+
+        m_lastStart = start;
+        m_timer.start();
+    }
+
+    // Ranges of pages which should be loaded next, nearest first
+    QList<CacheRange> pagesAhead(RowIndex start, RowIndex count, RowIndex rowsCount) const {
+        QList<CacheRange> pages;
+        if (m_direction == 0 || count <= 0) { return pages; }
+
+        int ahead = m_velocity >= FAST_SCROLL_PAGES * count ? MAX_PAGES_AHEAD : 1;
+        for (int page = 1; page <= ahead; ++page) {
+            RowIndex first = start + m_direction * page * count;
+            RowIndex last = first + count - 1;
+
+            if (m_direction < 0) {
+                if (last < 0) { break; }
+                first = qMax<RowIndex>(0, first);
+            } else {
+                if (first >= rowsCount) { break; }
+                last = qMin(last, rowsCount - 1);
+            }
+            pages.append(CacheRange(first, last));
+        }
+        return pages;
+    }
+
+    quint64 generation() const { return m_generation; }
+    bool isCurrent(quint64 generation) const { return generation == m_generation; }
+
+    void reset() {
+        ++m_generation;
+        m_lastStart = -1;
+        m_direction = 0;
+        m_velocity = 0;
+        m_timer.invalidate();
+    }
+
+private:
+    QElapsedTimer m_timer;
+    RowIndex m_lastStart;
+    int m_direction;
+    double m_velocity;      // rows per second
+    quint64 m_generation;
+};
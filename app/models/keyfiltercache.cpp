@@ -0,0 +1,288 @@
+#include "keyfiltercache.h"
+#include <QStringList>
+#include <utility>
+
+namespace {
+    bool hasGlob(const QString &pattern) {
+        for (QChar c : pattern) {
+            if (c == '*' || c == '?' || c == '[' || c == '\\') { return true; }
+        }
+        return false;
+    }
+
+    // Unescaped literal parts of pattern between wildcards and character classes,
+    // first part is empty if pattern starts with a wildcard
+    QStringList literalRuns(const QString &pattern) {
+        QStringList runs{QString()};
+
+        for (int i = 0; i < pattern.size(); ++i) {
+            QChar c = pattern.at(i);
+            if (c == '\\' && i + 1 < pattern.size()) {
+                runs.last().append(pattern.at(++i));
+            } else if (c == '*' || c == '?') {
+                runs.append(QString());
+            } else if (c == '[') {
+                // NOTE: like in redis, unterminated class runs to the end of pattern
+                int j = i + 1;
+                if (j < pattern.size() && pattern.at(j) == '^') { ++j; }
+                for (; j < pattern.size() && pattern.at(j) != ']'; ++j) {
+                    if (pattern.at(j) == '\\') { ++j; }
+                }
+                i = j;
+                runs.append(QString());
+            } else {
+                runs.last().append(c);
+            }
+        }
+        return runs;
+    }
+
+    // Port of stringmatchlen() from redis-server without case folding
+    bool globMatch(const char *pattern, int patternLen, const char *string, int stringLen) {
+        while (patternLen > 0 && stringLen > 0) {
+            switch (pattern[0]) {
+            case '*':
+                while (patternLen > 1 && pattern[1] == '*') {
+                    pattern++;
+                    patternLen--;
+                }
+                if (patternLen == 1) { return true; }
+
+                while (stringLen > 0) {
+                    if (globMatch(pattern + 1, patternLen - 1, string, stringLen)) { return true; }
+                    string++;
+                    stringLen--;
+                }
+                return false;
+            case '?':
+                string++;
+                stringLen--;
+                break;
+            case '[': {
+                pattern++;
+                patternLen--;
+                bool negate = patternLen > 0 && pattern[0] == '^';
+                if (negate) {
+                    pattern++;
+                    patternLen--;
+                }
+
+                bool match = false;
+                forever {
+                    if (patternLen == 0) {
+                        pattern--;
+                        patternLen++;
+                        break;
+                    }
+                    if (pattern[0] == '\\' && patternLen >= 2) {
+                        pattern++;
+                        patternLen--;
+                        if (pattern[0] == string[0]) { match = true; }
+                    } else if (pattern[0] == ']') {
+                        break;
+                    } else if (patternLen >= 3 && pattern[1] == '-') {
+                        uchar start = static_cast<uchar>(pattern[0]);
+                        uchar end = static_cast<uchar>(pattern[2]);
+                        uchar c = static_cast<uchar>(string[0]);
+                        if (start > end) { std::swap(start, end); }
+                        pattern += 2;
+                        patternLen -= 2;
+                        if (c >= start && c <= end) { match = true; }
+                    } else if (pattern[0] == string[0]) {
+                        match = true;
+                    }
+                    pattern++;
+                    patternLen--;
+                }
+
+                if (negate) { match = !match; }
+                if (!match) { return false; }
+                string++;
+                stringLen--;
+                break;
+            }
+            case '\\':
+                if (patternLen >= 2) {
+                    pattern++;
+                    patternLen--;
+                }
+                // fall through
+            default:
+                if (pattern[0] != string[0]) { return false; }
+                string++;
+                stringLen--;
+                break;
+            }
+
+            pattern++;
+            patternLen--;
+        }
+
+        // NOTE: trailing stars match empty rest of key, SCAN MATCH * returns empty key as well
+        if (stringLen == 0) {
+            while (patternLen > 0 && pattern[0] == '*') {
+                pattern++;
+                patternLen--;
+            }
+        }
+        return patternLen == 0 && stringLen == 0;
+    }
+}
+
+
+bool KeyFilterCache::contains(uint dbIndex, const QString &pattern, const QByteArray &type) const {
+    return m_entries.contains(Key{dbIndex, pattern, type});
+}
+
+QSharedPointer<KeyFilterCache::Entry> KeyFilterCache::insert(uint dbIndex, const QString &pattern, const QByteArray &type) {
+    Key key{dbIndex, pattern, type};
+    auto existing = m_entries.find(key);
+    if (existing != m_entries.end()) {
+        erase(existing);
+    }
+
+    if (m_entries.size() >= MAX_ENTRIES) {
+        auto lru = m_entries.begin();
+        for (auto i = m_entries.begin(); i != m_entries.end(); ++i) {
+            if (i.value()->lastUse < lru.value()->lastUse) { lru = i; }
+        }
+        erase(lru);
+    }
+
+    auto entry = QSharedPointer<Entry>(new Entry());
+    entry->lastUse = ++m_useCounter;
+    m_entries.insert(key, entry);
+    return entry;
+}
+
+void KeyFilterCache::append(const QSharedPointer<Entry> &entry, const RedisClient::Connection::RawKeysList &keys) {
+    if (!entry->valid) { return; }
+
+    qint64 bytes = 0;
+    for (const QByteArray &key : keys) {
+        bytes += keyBytes(key);
+    }
+
+    // NOTE: keys of a filter which can't fit into cache alone are not kept
+    if (entry->bytes + bytes > MAX_BYTES) {
+        return remove(entry);
+    }
+
+    entry->keys.append(keys);
+    entry->bytes += bytes;
+    m_bytes += bytes;
+    evict(entry);
+}
+
+void KeyFilterCache::remove(const QSharedPointer<Entry> &entry) {
+    for (auto i = m_entries.begin(); i != m_entries.end(); ++i) {
+        if (i.value() == entry) {
+            erase(i);
+            return;
+        }
+    }
+    entry->valid = false;
+}
+
+bool KeyFilterCache::refilter(uint dbIndex, const QString &pattern, const QByteArray &type, RedisClient::Connection::RawKeysList &result) {
+    QSharedPointer<Entry> source;
+    for (auto i = m_entries.constBegin(); i != m_entries.constEnd(); ++i) {
+        const auto &candidate = i.value();
+        if (i.key().dbIndex != dbIndex || i.key().type != type || !candidate->complete || !isUsable(candidate)) { continue; }
+        if (!narrows(pattern, i.key().pattern)) { continue; }
+
+        // Smallest matching key set is the cheapest to filter
+        if (!source || candidate->keys.size() < source->keys.size()) { source = candidate; }
+    }
+    if (!source) { return false; }
+
+    source->lastUse = ++m_useCounter;
+
+    QByteArray filter = pattern.toUtf8();
+    result.clear();
+    for (const QByteArray &key : source->keys) {
+        if (matches(filter, key)) { result.append(key); }
+    }
+
+    auto entry = insert(dbIndex, pattern, type);
+    entry->created = source->created;
+    append(entry, result);
+    entry->complete = true;
+    return true;
+}
+
+void KeyFilterCache::removeKey(uint dbIndex, const QByteArray &key) {
+    for (auto i = m_entries.begin(); i != m_entries.end(); ++i) {
+        if (i.key().dbIndex != dbIndex) { continue; }
+
+        qint64 removed = i.value()->keys.removeAll(key) * keyBytes(key);
+        i.value()->bytes -= removed;
+        m_bytes -= removed;
+    }
+}
+
+void KeyFilterCache::invalidate(uint dbIndex) {
+    for (auto i = m_entries.begin(); i != m_entries.end();) {
+        if (i.key().dbIndex == dbIndex) {
+            i = erase(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+void KeyFilterCache::clear() {
+    for (auto i = m_entries.begin(); i != m_entries.end();) {
+        i = erase(i);
+    }
+}
+
+bool KeyFilterCache::narrows(const QString &pattern, const QString &broader) {
+    if (pattern == broader || broader == "*") { return true; }
+
+    QStringList runs = literalRuns(pattern);
+
+    // prefix*
+    QString literal = broader.left(broader.size() - 1);
+    if (broader.endsWith('*') && !hasGlob(literal)) {
+        return runs.first().startsWith(literal);
+    }
+
+    // *infix*
+    literal = broader.mid(1, broader.size() - 2);
+    if (broader.size() > 2 && broader.startsWith('*') && broader.endsWith('*') && !hasGlob(literal)) {
+        for (const QString &run : runs) {
+            if (run.contains(literal)) { return true; }
+        }
+    }
+    return false;
+}
+
+bool KeyFilterCache::matches(const QByteArray &pattern, const QByteArray &key) {
+    return globMatch(pattern.constData(), pattern.size(), key.constData(), key.size());
+}
+
+bool KeyFilterCache::isUsable(const QSharedPointer<Entry> &entry) const {
+    return entry->valid && QDateTime::currentMSecsSinceEpoch() - entry->created <= MAX_AGE_MS;
+}
+
+KeyFilterCache::Iterator KeyFilterCache::erase(Iterator i) {
+    auto entry = i.value();
+    entry->valid = false;
+    entry->keys.clear();
+    m_bytes -= entry->bytes;
+    entry->bytes = 0;
+    return m_entries.erase(i);
+}
+
+void KeyFilterCache::evict(const QSharedPointer<Entry> &keep) {
+    while (m_bytes > MAX_BYTES) {
+        auto lru = m_entries.end();
+        for (auto i = m_entries.begin(); i != m_entries.end(); ++i) {
+            if (i.value() == keep) { continue; }
+            if (lru == m_entries.end() || i.value()->lastUse < lru.value()->lastUse) { lru = i; }
+        }
+        if (lru == m_entries.end()) { return; }
+        erase(lru);
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <QDateTime>
+#include <QHash>
+#include <QSharedPointer>
+#include "connection.h"
+#include "keyscanner.h"
+
+
+// Keys found by SCAN for (db, pattern, type) filters.
+// Cache is used only while user narrows the filter: a filter which narrows a
+// completely scanned one is answered by filtering cached keys on the client.
+// Reloading a filter always scans again. Cached keys are bounded by bytes.
+class KeyFilterCache {
+public:
+    static const int MAX_ENTRIES = 16;
+    static const qint64 MAX_BYTES = 64 * 1024 * 1024;
+    static const qint64 MAX_AGE_MS = 60 * 1000;     // bounds staleness caused by other clients
+
+    struct Entry {
+        RedisClient::Connection::RawKeysList keys;
+        QSharedPointer<KeyScanner> scanner;
+        qint64 bytes = 0;
+        bool complete = false;
+        bool valid = true;
+        qint64 created = QDateTime::currentMSecsSinceEpoch();
+        qint64 lastUse = 0;
+    };
+
+public:
+    bool contains(uint dbIndex, const QString &pattern, const QByteArray &type) const;
+    QSharedPointer<Entry> insert(uint dbIndex, const QString &pattern, const QByteArray &type);
+
+    // Adds scanned keys, entry which doesn't fit into cache is dropped
+    void append(const QSharedPointer<Entry> &entry, const RedisClient::Connection::RawKeysList &keys);
+    void remove(const QSharedPointer<Entry> &entry);
+
+    // Filters keys of a complete entry whose pattern contains given one
+    bool refilter(uint dbIndex, const QString &pattern, const QByteArray &type, RedisClient::Connection::RawKeysList &result);
+
+    void removeKey(uint dbIndex, const QByteArray &key);
+    void invalidate(uint dbIndex);
+    void clear();
+
+    // True if every key matched by pattern is also matched by broader
+    static bool narrows(const QString &pattern, const QString &broader);
+
+    // Glob matching of redis-server, key is compared as bytes
+    static bool matches(const QByteArray &pattern, const QByteArray &key);
+
+private:
+    struct Key {
+        uint dbIndex;
+        QString pattern;
+        QByteArray type;
+
+        bool operator==(const Key &other) const {
+            return dbIndex == other.dbIndex && pattern == other.pattern && type == other.type;
+        }
+    };
+    friend uint qHash(const Key &key, uint seed) { return qHash(key.pattern, seed) ^ qHash(key.type, seed) ^ key.dbIndex; }
+
+    typedef QHash<Key, QSharedPointer<Entry>>::iterator Iterator;
+
+    bool isUsable(const QSharedPointer<Entry> &entry) const;
+    Iterator erase(Iterator i);
+    void evict(const QSharedPointer<Entry> &keep);
+
+    // QList node and QByteArray header of every cached key
+    static qint64 keyBytes(const QByteArray &key) { return key.size() + 32; }
+
+private:
+    QHash<Key, QSharedPointer<Entry>> m_entries;
+    qint64 m_bytes = 0;
+    qint64 m_useCounter = 0;
+};
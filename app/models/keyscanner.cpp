@@ -0,0 +1,113 @@
+#include "keyscanner.h"
+#include <QCoreApplication>
+#include <QStringList>
+#include "scancountcontroller.h"
+
+
+KeyScanner::KeyScanner(QSharedPointer<RedisClient::Connection> connection, const QByteArray &pattern, int dbIndex, long count, qulonglong keysLimit)
+    : QObject(), m_connection(connection), m_pattern(pattern), m_dbIndex(dbIndex), m_count(count),
+      m_cursor(0), m_keysLimit(keysLimit), m_loadedKeys(0), m_running(false), m_finished(false) {}
+
+QByteArray KeyScanner::takeTypeFilter(QString &filter) {
+    static const QStringList types = {"string", "list", "set", "zset", "hash", "stream"};
+    static const QString prefix("type:");
+
+    if (!filter.startsWith(prefix, Qt::CaseInsensitive)) { return QByteArray(); }
+
+    int end = filter.indexOf(' ', prefix.size());
+    QString type = filter.mid(prefix.size(), end == -1 ? -1 : end - prefix.size()).toLower();
+    if (!types.contains(type)) { return QByteArray(); }
+
+    filter = end == -1 ? QString() : filter.mid(end + 1).trimmed();
+    return type.toUtf8();
+}
+
+void KeyScanner::start(BatchCallback callback) {
+    m_callback = callback;
+    m_cursor = 0;
+    m_loadedKeys = 0;
+    m_running = true;
+    m_finished = false;
+    scanNext();
+}
+
+void KeyScanner::loadMore(qulonglong keys) {
+    if (!hasMore()) { return; }
+
+    m_keysLimit = m_keysLimit > 0 ? m_loadedKeys + keys : 0;
+    m_running = true;
+    scanNext();
+}
+
+void KeyScanner::cancel() {
+    m_running = false;
+    m_finished = true;
+    m_callback = BatchCallback();
+}
+
+void KeyScanner::scanNext() {
+    if (!m_running) { return; }
+
+    ScanCountController *controller = m_count == ADAPTIVE_SCAN_COUNT ? ScanCountController::of(m_connection.data(), "SCAN") : nullptr;
+    long count = controller ? controller->count() : m_count;
+
+    QList<QByteArray> cmd = {"SCAN", QByteArray::number(m_cursor), "MATCH", m_pattern, "COUNT", QByteArray::number(static_cast<qlonglong>(count))};
+    if (!m_type.isEmpty()) {
+        cmd << "TYPE" << m_type;
+    }
+
+    auto onError = [this](const QString &err) {
+        pause(RedisClient::Connection::RawKeysList(), QCoreApplication::translate("RDM", "Cannot load keys: %1").arg(err), true);
+    };
+
+    auto onKeys = [this, onError](const RedisClient::Response &r) {
+        if (!m_running) { return; }
+
+        if (!r.isValidScanResponse()) {
+            return onError(QCoreApplication::translate("RDM", "Cannot parse scan response"));
+        }
+
+        RedisClient::Connection::RawKeysList keys;
+        QVariantList collection = r.getCollection();
+        keys.reserve(collection.size());
+        for (const QVariant &key : collection) {
+            keys.append(key.toByteArray());
+        }
+
+        m_cursor = r.getCursor();
+        m_loadedKeys += keys.size();
+
+        if (m_cursor == 0) {
+            return pause(keys, QString(), true);
+        }
+
+        if (m_keysLimit > 0 && m_loadedKeys >= m_keysLimit) {
+            return pause(keys, QString(), false);
+        }
+
+        if (m_callback) {
+            m_callback(keys, QString(), false);
+        }
+        scanNext();
+    };
+
+    if (controller) {
+        controller->run(m_connection.data(), cmd, count, this, m_dbIndex, onKeys, onError);
+    } else {
+        m_connection->cmd(cmd, this, m_dbIndex, onKeys, onError);
+    }
+}
+
+void KeyScanner::pause(const RedisClient::Connection::RawKeysList &keys, const QString &err, bool finished) {
+    m_running = false;
+    m_finished = finished;
+
+    auto callback = m_callback;
+    if (finished) {
+        m_callback = BatchCallback();
+    }
+
+    if (callback) {
+        callback(keys, err, true);
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <QObject>
+#include <QSharedPointer>
+#include <functional>
+#include "connection.h"
+
+
+// Incremental SCAN over a single connection.
+// Every SCAN page is delivered to callback as soon as it arrives. If keys limit
+// is set, scanning pauses once the limit is reached (at page granularity) and
+// loadMore() continues from the same cursor.
+class KeyScanner : public QObject {
+    Q_OBJECT
+
+public:
+    // finished - no more batches until loadMore() is called
+    typedef std::function<void(const RedisClient::Connection::RawKeysList &keys, const QString &err, bool finished)> BatchCallback;
+
+    // COUNT is tuned by connection's ScanCountController
+    static const long ADAPTIVE_SCAN_COUNT = 0;
+
+public:
+    KeyScanner(QSharedPointer<RedisClient::Connection> connection, const QByteArray &pattern, int dbIndex = -1,
+               long count = ADAPTIVE_SCAN_COUNT, qulonglong keysLimit = 0);
+
+    // Server side TYPE filter, requires redis-server >= 6.0
+    void setTypeFilter(const QByteArray &type) { m_type = type; }
+
+    // Removes leading "type:<name>" token of keys filter (e.g. "type:hash user:*")
+    // and returns type name, filter is left unchanged if it has no known type
+    static QByteArray takeTypeFilter(QString &filter);
+
+    void start(BatchCallback callback);
+    void setCallback(BatchCallback callback) { m_callback = callback; }
+    void loadMore(qulonglong keys);
+    void cancel();
+
+    bool isRunning() const { return m_running; }
+    bool isFinished() const { return m_finished; }
+    bool hasMore() const { return !m_running && !m_finished; }
+    qulonglong loadedKeys() const { return m_loadedKeys; }
+
+private:
+    void scanNext();
+    void pause(const RedisClient::Connection::RawKeysList &keys, const QString &err, bool finished);
+
+private:
+    QSharedPointer<RedisClient::Connection> m_connection;
+    QByteArray m_pattern;
+    QByteArray m_type;
+    int m_dbIndex;
+    long m_count;
+    qulonglong m_cursor;
+    qulonglong m_keysLimit;
+    qulonglong m_loadedKeys;
+    bool m_running;
+    bool m_finished;
+    BatchCallback m_callback;
+};
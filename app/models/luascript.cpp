@@ -0,0 +1,41 @@
+#include "luascript.h"
+#include <QCryptographicHash>
+#include <QPointer>
+
+
+LuaScript::LuaScript(const QByteArray &source)
+    : m_source(source), m_sha(QCryptographicHash::hash(source, QCryptographicHash::Sha1).toHex()) {}
+
+void LuaScript::eval(RedisClient::Connection *connection, const QList<QByteArray> &keys, const QList<QByteArray> &args,
+                     QObject *owner, int db, RedisClient::Command::Callback callback) const {
+    eval(connection, keys, args, owner, db, callback, true);
+}
+
+void LuaScript::eval(RedisClient::Connection *connection, const QList<QByteArray> &keys, const QList<QByteArray> &args,
+                     QObject *owner, int db, RedisClient::Command::Callback callback, bool useSha) const {
+    QList<QByteArray> cmd;
+    if (useSha) {
+        cmd << "EVALSHA" << m_sha;
+    } else {
+        cmd << "EVAL" << m_source;
+    }
+    cmd << QByteArray::number(keys.size()) << keys << args;
+
+    LuaScript script = *this;
+    QPointer<RedisClient::Connection> target(connection);
+
+    try {
+        connection->command(cmd, owner, [script, target, keys, args, owner, db, callback, useSha](RedisClient::Response r, QString err) {
+            if (err.isEmpty() && r.isErrorMessage()) {
+                err = r.value().toString();
+            }
+
+            if (useSha && err.startsWith("NOSCRIPT") && target) {
+                return script.eval(target.data(), keys, args, owner, db, callback, false);
+            }
+            callback(r, err);
+        }, db);
+    } catch (const RedisClient::Connection::Exception &e) {
+        callback(RedisClient::Response(), QString(e.what()));
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include "connection.h"
+
+
+// Lua script called with EVALSHA, script body is sent with EVAL only after
+// server replies with NOSCRIPT. Error replies are reported as errors, so the
+// callback doesn't have to inspect response type.
+class LuaScript {
+public:
+    explicit LuaScript(const QByteArray &source);
+
+    QByteArray sha() const { return m_sha; }
+
+    void eval(RedisClient::Connection *connection, const QList<QByteArray> &keys, const QList<QByteArray> &args,
+              QObject *owner, int db, RedisClient::Command::Callback callback) const;
+
+private:
+    void eval(RedisClient::Connection *connection, const QList<QByteArray> &keys, const QList<QByteArray> &args,
+              QObject *owner, int db, RedisClient::Command::Callback callback, bool useSha) const;
+
+private:
+    QByteArray m_source;
+    QByteArray m_sha;
+};
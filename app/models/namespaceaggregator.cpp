@@ -0,0 +1,117 @@
+#include "namespaceaggregator.h"
+#include <QCoreApplication>
+#include "app/models/luascript.h"
+
+namespace {
+    // ARGV: cursor, pattern, scan count, max scans, separator, level prefix
+    // Returns: {cursor, {namespace, count, ...}, {key, ...}}
+    const QByteArray AGGREGATE_SCRIPT = R"lua(
+local cursor = ARGV[1]
+local count = tonumber(ARGV[3])
+local scans = tonumber(ARGV[4])
+local separator = ARGV[5]
+local levelPrefix = ARGV[6]
+local offset = #levelPrefix
+local namespaces = {}
+local keys = {}
+
+repeat
+    local r = redis.call('SCAN', cursor, 'MATCH', ARGV[2], 'COUNT', count)
+    cursor = r[1]
+    for _, key in ipairs(r[2]) do
+        if string.sub(key, 1, offset) == levelPrefix then
+            local pos = string.find(key, separator, offset + 1, true)
+            if pos then
+                local ns = string.sub(key, 1, pos - 1)
+                namespaces[ns] = (namespaces[ns] or 0) + 1
+            else
+                keys[#keys + 1] = key
+            end
+        end
+    end
+    scans = scans - 1
+until cursor == '0' or scans <= 0
+
+local result = {}
+for ns, total in pairs(namespaces) do
+    result[#result + 1] = ns
+    result[#result + 1] = total
+end
+return {cursor, result, keys}
+)lua";
+}
+
+
+NamespaceAggregator::NamespaceAggregator(QSharedPointer<RedisClient::Connection> connection, const QString &separator, int dbIndex)
+    : QObject(), m_connection(connection), m_separator(separator.toUtf8()), m_dbIndex(dbIndex) {}
+
+void NamespaceAggregator::load(const QByteArray &prefix, const QByteArray &pattern, RedisClient::Connection::NamespaceItemsCallback callback) {
+    m_prefix = prefix;
+    m_pattern = pattern;
+    m_cursor = "0";
+    m_namespaces.clear();
+    m_keys.clear();
+    m_callback = callback;
+    evalNext();
+}
+
+void NamespaceAggregator::cancel() {
+    m_callback = RedisClient::Connection::NamespaceItemsCallback();
+}
+
+void NamespaceAggregator::evalNext() {
+    static const LuaScript script(AGGREGATE_SCRIPT);
+
+    if (!m_callback) { return; }
+
+    QList<QByteArray> args;
+    args << m_cursor << m_pattern << QByteArray::number(DEFAULT_SCAN_COUNT) << QByteArray::number(DEFAULT_SCANS_PER_CALL)
+        << m_separator << (m_prefix.isEmpty() ? QByteArray() : m_prefix + m_separator);
+
+    script.eval(m_connection.data(), {}, args, this, m_dbIndex, [this](RedisClient::Response r, QString err) {
+        if (!m_callback) { return; }
+
+        if (!err.isEmpty()) {
+            return finish(err);
+        }
+
+        QVariantList result = r.value().toList();
+        if (result.size() != 3) {
+            return finish(QCoreApplication::translate("RDM", "Invalid namespace aggregation response"));
+        }
+
+        QVariantList namespaces = result.at(1).toList();
+        for (int i = 0; i + 1 < namespaces.size(); i += 2) {
+            m_namespaces[namespaces.at(i).toByteArray()] += namespaces.at(i + 1).toULongLong();
+        }
+        for (const QVariant &key : result.at(2).toList()) {
+            m_keys.append(key.toByteArray());
+        }
+
+        m_cursor = result.at(0).toByteArray();
+        if (m_cursor == "0") {
+            return finish(QString());
+        }
+        evalNext();
+    });
+}
+
+void NamespaceAggregator::finish(const QString &err) {
+    auto callback = m_callback;
+    m_callback = RedisClient::Connection::NamespaceItemsCallback();
+    if (!callback) { return; }
+
+    if (!err.isEmpty()) {
+        return callback(RedisClient::Connection::NamespaceItems(), err);
+    }
+
+    RedisClient::Connection::RootNamespaces namespaces;
+    namespaces.reserve(m_namespaces.size());
+    for (auto i = m_namespaces.constBegin(); i != m_namespaces.constEnd(); ++i) {
+        namespaces.append({i.key(), i.value()});
+    }
+
+    callback({namespaces, m_keys}, QString());
+    m_namespaces.clear();
+    m_keys.clear();
+}
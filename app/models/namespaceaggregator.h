@@ -0,0 +1,43 @@
+#pragma once
+#include <QByteArray>
+#include <QMap>
+#include <QObject>
+#include <QSharedPointer>
+#include "connection.h"
+
+
+// Groups keys of one namespace level on the server side.
+// Lua script SCANs a bounded chunk of the keyspace, splits keys by namespace
+// separator and returns only namespace counts and keys of the requested level,
+// so expanding a namespace transfers data proportional to the visible tree.
+// Script is called through LuaScript, so it is sent in full only after NOSCRIPT.
+class NamespaceAggregator : public QObject {
+    Q_OBJECT
+
+public:
+    static const int DEFAULT_SCAN_COUNT = 1000;
+    static const int DEFAULT_SCANS_PER_CALL = 10;
+
+public:
+    NamespaceAggregator(QSharedPointer<RedisClient::Connection> connection, const QString &separator, int dbIndex);
+
+    // Loads namespaces and keys directly under prefix, empty prefix means root level.
+    // Pattern is applied to full key names, keys outside of prefix are skipped.
+    void load(const QByteArray &prefix, const QByteArray &pattern, RedisClient::Connection::NamespaceItemsCallback callback);
+    void cancel();
+
+private:
+    void evalNext();
+    void finish(const QString &err);
+
+private:
+    QSharedPointer<RedisClient::Connection> m_connection;
+    QByteArray m_separator;
+    int m_dbIndex;
+    QByteArray m_prefix;
+    QByteArray m_pattern;
+    QByteArray m_cursor;
+    QMap<QByteArray, ulong> m_namespaces;
+    RedisClient::Connection::RootKeys m_keys;
+    RedisClient::Connection::NamespaceItemsCallback m_callback;
+};
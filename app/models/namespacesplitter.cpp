@@ -0,0 +1,120 @@
+#include "namespacesplitter.h"
+#include <QThread>
+#include <QtConcurrent>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NAMESPACE_SPLITTER_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace NamespaceSplitter {
+
+namespace {
+
+#ifdef NAMESPACE_SPLITTER_SSE2
+    inline int countTrailingZeros(unsigned mask) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+#endif
+
+    inline bool matchesAt(const char* data, int pos, const QByteArray& separator) {
+        return separator.size() == 1 || std::memcmp(data + pos + 1, separator.constData() + 1, separator.size() - 1) == 0;
+    }
+
+    Result splitRange(const RedisClient::Connection::RawKeysList& keys, int from, int to, const QByteArray& separator) {
+        Result result;
+        result.offsets.reserve(to - from + 1);
+        result.offsets.append(0);
+
+        for (int k = from; k < to; ++k) {
+            const QByteArray& key = keys.at(k);
+            findSeparators(key.constData(), key.size(), separator, result.positions);
+            result.offsets.append(result.positions.size());
+        }
+        return result;
+    }
+
+    void merge(Result& result, const Result& part) {
+        int base = result.positions.size();
+        result.positions.append(part.positions);
+        for (int i = 1; i < part.offsets.size(); ++i) {
+            result.offsets.append(base + part.offsets.at(i));
+        }
+    }
+
+}  // namespace
+
+
+void findSeparators(const char* data, int size, const QByteArray& separator, QVector<int>& positions) {
+    const int separatorSize = separator.size();
+    if (separatorSize == 0 || size < separatorSize) { return; }
+
+    const int lastStart = size - separatorSize;
+    const char first = separator.at(0);
+    int next = 0;   // separators don't overlap
+    int i = 0;
+
+#ifdef NAMESPACE_SPLITTER_SSE2
+    const __m128i needle = _mm_set1_epi8(first);
+    for (; i + 16 <= size; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+
+        while (mask) {
+            int pos = i + countTrailingZeros(mask);
+            mask &= mask - 1;
+
+            if (pos > lastStart) { return; }
+            if (pos < next || !matchesAt(data, pos, separator)) { continue; }
+
+            positions.append(pos);
+            next = pos + separatorSize;
+        }
+    }
+#endif
+
+    for (i = qMax(i, next); i <= lastStart; ++i) {
+        const void* found = std::memchr(data + i, first, lastStart - i + 1);
+        if (!found) { return; }
+
+        i = static_cast<int>(static_cast<const char*>(found) - data);
+        if (matchesAt(data, i, separator)) {
+            positions.append(i);
+            i += separatorSize - 1;
+        }
+    }
+}
+
+Result split(const RedisClient::Connection::RawKeysList& keys, const QByteArray& separator) {
+    int tasks = qBound(1, keys.size() / MIN_KEYS_PER_TASK, QThread::idealThreadCount());
+    if (tasks == 1) {
+        return splitRange(keys, 0, keys.size(), separator);
+    }
+
+    int chunk = (keys.size() + tasks - 1) / tasks;
+    QList<QFuture<Result>> parts;
+    for (int from = 0; from < keys.size(); from += chunk) {
+        int to = qMin(from + chunk, keys.size());
+        parts.append(QtConcurrent::run([&keys, from, to, &separator]() {
+            return splitRange(keys, from, to, separator);
+        }));
+    }
+
+    Result result = parts.first().result();
+    for (int i = 1; i < parts.size(); ++i) {
+        merge(result, parts.at(i).result());
+    }
+    return result;
+}
+
+}  // namespace NamespaceSplitter
@@ -0,0 +1,30 @@
+#pragma once
+#include <QByteArray>
+#include <QVector>
+#include "connection.h"
+
+// Batch splitting of key names by namespace separator.
+// Separator positions are searched 16 bytes at a time with SSE2 (scalar
+// fallback on other CPUs) and big batches are partitioned across the global
+// thread pool. Callers split key batches in a worker thread.
+namespace NamespaceSplitter {
+
+    // Batches smaller than this are split in the calling thread
+    const int MIN_KEYS_PER_TASK = 16 * 1024;
+
+    struct Result {
+        // Separator positions of key i are positions[offsets[i]] .. positions[offsets[i + 1] - 1]
+        QVector<int> positions;
+        QVector<int> offsets;
+
+        int keysCount() const { return qMax(0, offsets.size() - 1); }
+        const int* separators(int key) const { return positions.constData() + offsets.at(key); }
+        int separatorsCount(int key) const { return offsets.at(key + 1) - offsets.at(key); }
+    };
+
+    // Appends positions of all non-overlapping separator occurrences
+    void findSeparators(const char* data, int size, const QByteArray& separator, QVector<int>& positions);
+
+    Result split(const RedisClient::Connection::RawKeysList& keys, const QByteArray& separator);
+
+}  // namespace NamespaceSplitter
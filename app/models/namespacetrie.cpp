@@ -0,0 +1,220 @@
+#include "namespacetrie.h"
+#include <cstring>
+
+
+NamespaceTrie::NamespaceTrie(const QByteArray &separator) : m_separator(separator) {
+    clear();
+}
+
+void NamespaceTrie::clear() {
+    m_arena.clear();
+    m_segments.clear();
+    m_segmentIndex.clear();
+    m_children.clear();
+    m_nodes.clear();
+    m_nodes.append({0, INVALID_NODE, INVALID_NODE, INVALID_NODE, 0, false});
+}
+
+void NamespaceTrie::insert(const RedisClient::Connection::RawKeysList &keys) {
+    for (const QByteArray &key : keys) {
+        insert(key);
+    }
+}
+
+void NamespaceTrie::insert(const QByteArray &key) {
+    NodeId node = ROOT;
+    int start = 0;
+
+    forever {
+        int end = m_separator.isEmpty() ? -1 : key.indexOf(m_separator, start);
+        int length = (end == -1 ? key.size() : end) - start;
+
+        quint32 segment = intern(key.constData() + start, length);
+        NodeId next = child(node, segment);
+        if (next == INVALID_NODE) {
+            next = addChild(node, segment);
+        }
+        node = next;
+
+        if (end == -1) { break; }
+        start = end + m_separator.size();
+    }
+
+    markKey(node);
+}
+
+void NamespaceTrie::insert(const RedisClient::Connection::RawKeysList &keys, const NamespaceSplitter::Result &split) {
+    // NOTE: every key of the batch is at least one new node, namespace nodes grow the trie geometrically
+    reserveNodes(keys.size());
+
+    for (int i = 0; i < keys.size() && i < split.keysCount(); ++i) {
+        insert(keys.at(i), split.separators(i), split.separatorsCount(i));
+    }
+}
+
+void NamespaceTrie::insert(const QByteArray &key, const int *separators, int count) {
+    NodeId node = ROOT;
+    int start = 0;
+
+    for (int i = 0; i <= count; ++i) {
+        int end = i < count ? separators[i] : key.size();
+
+        quint32 segment = intern(key.constData() + start, end - start);
+        NodeId next = child(node, segment);
+        if (next == INVALID_NODE) {
+            next = addChild(node, segment);
+        }
+        node = next;
+        start = end + m_separator.size();
+    }
+
+    markKey(node);
+}
+
+void NamespaceTrie::reserveNodes(int count) {
+    int required = m_nodes.size() + count;
+    if (required <= m_nodes.capacity()) { return; }
+
+    required = qMax(required, m_nodes.capacity() * 2);
+    m_nodes.reserve(required);
+    m_children.reserve(required);
+}
+
+void NamespaceTrie::markKey(NodeId node) {
+    // NOTE: SCAN may return the same key more than once
+    if (m_nodes.at(node).isKey) { return; }
+
+    m_nodes[node].isKey = true;
+    for (; node != INVALID_NODE; node = m_nodes.at(node).parent) {
+        m_nodes[node].keys++;
+    }
+}
+
+bool NamespaceTrie::remove(const QByteArray &key) {
+    NodeId node = find(key);
+    if (node == INVALID_NODE || !m_nodes.at(node).isKey) { return false; }
+
+    // Empty nodes are kept and skipped by items()
+    m_nodes[node].isKey = false;
+    for (; node != INVALID_NODE; node = m_nodes.at(node).parent) {
+        m_nodes[node].keys--;
+    }
+    return true;
+}
+
+NamespaceTrie::NodeId NamespaceTrie::find(const QByteArray &path) const {
+    if (path.isEmpty()) { return ROOT; }
+
+    NodeId node = ROOT;
+    int start = 0;
+
+    while (node != INVALID_NODE) {
+        int end = m_separator.isEmpty() ? -1 : path.indexOf(m_separator, start);
+        int length = (end == -1 ? path.size() : end) - start;
+
+        node = findSegment(node, path.constData() + start, length);
+        if (end == -1) { break; }
+        start = end + m_separator.size();
+    }
+    return node;
+}
+
+QByteArray NamespaceTrie::name(NodeId node) const {
+    return QByteArray(segmentData(node));
+}
+
+QByteArray NamespaceTrie::segmentData(NodeId node) const {
+    const Segment &s = m_segments.at(m_nodes.at(node).segment);
+    return QByteArray::fromRawData(m_arena.constData() + s.offset, s.length);
+}
+
+QByteArray NamespaceTrie::fullPath(NodeId node) const {
+    QVector<NodeId> path;
+    int size = 0;
+    for (; node != ROOT && node != INVALID_NODE; node = m_nodes.at(node).parent) {
+        path.append(node);
+        size += m_segments.at(m_nodes.at(node).segment).length + m_separator.size();
+    }
+
+    QByteArray result;
+    result.reserve(size);
+    for (int i = path.size() - 1; i >= 0; --i) {
+        result.append(segmentData(path.at(i)));
+        if (i > 0) { result.append(m_separator); }
+    }
+    return result;
+}
+
+QVector<NamespaceTrie::NodeId> NamespaceTrie::children(NodeId node) const {
+    QVector<NodeId> result;
+    for (NodeId child = m_nodes.at(node).firstChild; child != INVALID_NODE; child = m_nodes.at(child).nextSibling) {
+        result.append(child);
+    }
+    return result;
+}
+
+RedisClient::Connection::NamespaceItems NamespaceTrie::items(NodeId node) const {
+    RedisClient::Connection::NamespaceItems result;
+
+    for (NodeId child : children(node)) {
+        const Node &n = m_nodes.at(child);
+        ulong namespaceKeys = n.keys - (n.isKey ? 1 : 0);
+
+        if (namespaceKeys > 0) {
+            result.first.append({fullPath(child), namespaceKeys});
+        }
+        if (n.isKey) {
+            result.second.append(fullPath(child));
+        }
+    }
+    return result;
+}
+
+qulonglong NamespaceTrie::memoryUsage() const {
+    return m_arena.capacity()
+            + m_nodes.capacity() * sizeof(Node)
+            + m_children.capacity() * (sizeof(quint64) + sizeof(NodeId) + sizeof(void*) * 2)
+            + m_segments.capacity() * sizeof(Segment)
+            + m_segmentIndex.capacity() * (sizeof(uint) + sizeof(quint32) + sizeof(void*) * 2);
+}
+
+quint32 NamespaceTrie::intern(const char *data, int length) {
+    uint hash = qHash(QByteArray::fromRawData(data, length));
+
+    for (auto i = m_segmentIndex.constFind(hash); i != m_segmentIndex.constEnd() && i.key() == hash; ++i) {
+        const Segment &s = m_segments.at(i.value());
+        if (static_cast<int>(s.length) == length && std::memcmp(m_arena.constData() + s.offset, data, length) == 0) {
+            return i.value();
+        }
+    }
+
+    quint32 segment = m_segments.size();
+    m_segments.append({static_cast<quint32>(m_arena.size()), static_cast<quint32>(length)});
+    m_arena.append(data, length);
+    m_segmentIndex.insert(hash, segment);
+    return segment;
+}
+
+NamespaceTrie::NodeId NamespaceTrie::child(NodeId parent, quint32 segment) const {
+    return m_children.value(childKey(parent, segment), INVALID_NODE);
+}
+
+NamespaceTrie::NodeId NamespaceTrie::findSegment(NodeId parent, const char *data, int length) const {
+    uint hash = qHash(QByteArray::fromRawData(data, length));
+
+    for (auto i = m_segmentIndex.constFind(hash); i != m_segmentIndex.constEnd() && i.key() == hash; ++i) {
+        const Segment &s = m_segments.at(i.value());
+        if (static_cast<int>(s.length) == length && std::memcmp(m_arena.constData() + s.offset, data, length) == 0) {
+            return child(parent, i.value());
+        }
+    }
+    return INVALID_NODE;
+}
+
+NamespaceTrie::NodeId NamespaceTrie::addChild(NodeId parent, quint32 segment) {
+    NodeId node = m_nodes.size();
+    m_nodes.append({segment, parent, INVALID_NODE, m_nodes.at(parent).firstChild, 0, false});
+    m_nodes[parent].firstChild = node;
+    m_children.insert(childKey(parent, segment), node);
+    return node;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <QByteArray>
+#include <QHash>
+#include <QMultiHash>
+#include <QVector>
+#include "connection.h"
+#include "namespacesplitter.h"
+
+
+// Namespace tree of scanned keys.
+// Every node is one path segment. Segment bytes are interned in a single
+// arena, so a segment like "order" repeated under million namespaces is
+// stored once and memory grows with unique segments, not with key bytes.
+// Nodes keep number of keys in their subtree, so expanding a namespace
+// doesn't need to split key names again.
+class NamespaceTrie {
+public:
+    typedef qint32 NodeId;
+    static const NodeId ROOT = 0;
+    static const NodeId INVALID_NODE = -1;
+
+public:
+    explicit NamespaceTrie(const QByteArray &separator);
+
+    void insert(const QByteArray &key);
+    void insert(const RedisClient::Connection::RawKeysList &keys);
+    // Inserts keys with separator positions found by NamespaceSplitter
+    void insert(const RedisClient::Connection::RawKeysList &keys, const NamespaceSplitter::Result &split);
+    bool remove(const QByteArray &key);
+    void clear();
+
+    NodeId find(const QByteArray &path) const;
+
+    int nodesCount() const { return m_nodes.size(); }
+    ulong keysCount(NodeId node = ROOT) const { return m_nodes.at(node).keys; }
+    bool isKey(NodeId node) const { return m_nodes.at(node).isKey; }
+    NodeId parent(NodeId node) const { return m_nodes.at(node).parent; }
+    QByteArray name(NodeId node) const;
+    QByteArray fullPath(NodeId node) const;
+
+    // Children are returned in insertion order reversed
+    QVector<NodeId> children(NodeId node) const;
+
+    // Namespaces with key counts and keys directly under node
+    RedisClient::Connection::NamespaceItems items(NodeId node = ROOT) const;
+
+    qulonglong memoryUsage() const;
+
+private:
+    struct Segment {
+        quint32 offset;
+        quint32 length;
+    };
+
+    struct Node {
+        quint32 segment;      // index in m_segments
+        NodeId parent;
+        NodeId firstChild;
+        NodeId nextSibling;
+        quint32 keys;         // keys in subtree including node itself
+        bool isKey;
+    };
+
+    void insert(const QByteArray &key, const int *separators, int count);
+    void reserveNodes(int count);
+    void markKey(NodeId node);
+    quint32 intern(const char *data, int length);
+    NodeId child(NodeId parent, quint32 segment) const;
+    NodeId findSegment(NodeId parent, const char *data, int length) const;
+    NodeId addChild(NodeId parent, quint32 segment);
+    QByteArray segmentData(NodeId node) const;
+
+    static quint64 childKey(NodeId parent, quint32 segment) { return (quint64(parent) << 32) | segment; }
+
+private:
+    QByteArray m_separator;
+    QByteArray m_arena;
+    QVector<Segment> m_segments;
+    QMultiHash<uint, quint32> m_segmentIndex;
+    QHash<quint64, NodeId> m_children;
+    QVector<Node> m_nodes;
+};
@@ -0,0 +1,274 @@
+#include "replicarouter.h"
+#include <QCoreApplication>
+#include <QtConcurrent>
+#include <algorithm>
+#include "app/models/hashslot.h"
+
+
+ReplicaRouter::ReplicaRouter(RedisClient::Connection *master, uint maxLag)
+    : QObject(master), m_maxLag(maxLag) {
+    m_refreshTimer.setInterval(DEFAULT_REFRESH_INTERVAL);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &ReplicaRouter::refresh);
+    connect(master, &RedisClient::Connection::connected, this, &ReplicaRouter::refresh);
+    m_refreshTimer.start();
+    m_clock.start();
+    refresh();
+}
+
+ReplicaRouter *ReplicaRouter::of(RedisClient::Connection *master) {
+    if (!master) { return nullptr; }
+    return master->findChild<ReplicaRouter *>(QString(), Qt::FindDirectChildrenOnly);
+}
+
+QSharedPointer<RedisClient::Connection> ReplicaRouter::readConnection(QSharedPointer<RedisClient::Connection> master, const QByteArray &key) {
+    ReplicaRouter *router = of(master.data());
+    if (!router) { return master; }
+
+    auto replica = router->connectionFor(key);
+    return replica ? replica : master;
+}
+
+void ReplicaRouter::pinToMaster(QSharedPointer<RedisClient::Connection> master, const QByteArray &key) {
+    ReplicaRouter *router = of(master.data());
+    if (!router) { return; }
+
+    qint64 now = router->m_clock.elapsed();
+    for (auto it = router->m_pinnedKeys.begin(); it != router->m_pinnedKeys.end();) {
+        if (it.value() <= now) {
+            it = router->m_pinnedKeys.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // NOTE: fresh replica acked replication stream at most max lag ago, one more
+    // second covers rounding of lag in INFO
+    router->m_pinnedKeys.insert(key, now + (router->m_maxLag + 1) * 1000LL);
+}
+
+void ReplicaRouter::closeConnections() {
+    auto connections = m_connections.values();
+    m_connections.clear();
+    if (connections.isEmpty()) { return; }
+
+    QtConcurrent::run([connections]() {
+        for (auto connection : connections) {
+            connection->disconnect();
+        }
+    });
+}
+
+QList<ReplicaRouter::Replica> ReplicaRouter::replicas() const {
+    return m_replicas;
+}
+
+QString ReplicaRouter::staleness() const {
+    QStringList result;
+    for (const Replica &replica : m_replicas) {
+        QString lag = replica.lag < 0 ? QCoreApplication::translate("RDM", "unknown lag")
+                                      : QCoreApplication::translate("RDM", "%1 s behind").arg(replica.lag);
+        if (replica.offsetBehind > 0) {
+            lag += QCoreApplication::translate("RDM", ", %1 bytes").arg(replica.offsetBehind);
+        }
+        result.append(QString("%1:%2 (%3)").arg(replica.host.first).arg(replica.host.second).arg(replica.online ? lag : QCoreApplication::translate("RDM", "offline")));
+    }
+    return result.join(", ");
+}
+
+void ReplicaRouter::refresh() {
+    auto connection = master();
+    if (!connection || !connection->isConnected()) { return; }
+
+    if (connection->mode() == RedisClient::Connection::Mode::Cluster) {
+        connection->cmd({"CLUSTER", "SLOTS"}, this, -1, [this](const RedisClient::Response &r) {
+            if (r.type() != RedisClient::Response::Array) { return; }
+            parseClusterSlots(r.value().toList());
+            refreshClusterLag();
+            emit replicasUpdated();
+        }, [](const QString &) {});
+    } else {
+        connection->cmd({"INFO", "replication"}, this, -1, [this](const RedisClient::Response &r) {
+            if (r.isErrorMessage()) { return; }
+            parseReplicationInfo(QString::fromUtf8(r.value().toByteArray()));
+            emit replicasUpdated();
+        }, [](const QString &) {});
+    }
+}
+
+RedisClient::Connection *ReplicaRouter::master() const {
+    return qobject_cast<RedisClient::Connection *>(parent());
+}
+
+QSharedPointer<RedisClient::Connection> ReplicaRouter::connectionFor(const QByteArray &key) {
+    if (isPinned(key)) { return QSharedPointer<RedisClient::Connection>(); }
+
+    QList<RedisClient::Connection::Host> candidates;
+
+    if (m_slots.isEmpty()) {
+        for (const Replica &replica : m_replicas) {
+            if (isFresh(replica)) { candidates.append(replica.host); }
+        }
+    } else {
+        int slot = HashSlot::keySlot(key);
+        auto range = m_slots.upperBound(slot);
+        if (range == m_slots.begin()) { return QSharedPointer<RedisClient::Connection>(); }
+        --range;
+        if (slot > range.value().end) { return QSharedPointer<RedisClient::Connection>(); }
+        for (const Replica &replica : m_replicas) {
+            if (isFresh(replica) && range.value().replicas.contains(replica.host)) { candidates.append(replica.host); }
+        }
+    }
+
+    if (candidates.isEmpty()) { return QSharedPointer<RedisClient::Connection>(); }
+
+    // NOTE: least lagging replica is first, see parseReplicationInfo() and parseReplicaInfo()
+    return replicaConnection(candidates.first());
+}
+
+QSharedPointer<RedisClient::Connection> ReplicaRouter::replicaConnection(const RedisClient::Connection::Host &host) {
+    auto connection = m_connections.value(host);
+    if (connection) { return connection; }
+
+    auto master = this->master();
+    if (!master) { return connection; }
+
+    // NOTE: same rule as ConnectionPool::nodeConnection(), announced addresses
+    // may be unreachable behind NAT or docker
+    RedisClient::ConnectionConfig config = master->getConfig();
+    if (!config.overrideClusterHost()) {
+        config.setHost(host.first);
+    }
+    config.setPort(host.second);
+
+    connection = master->clone(false);
+    connection->setConnectionConfig(config);
+    m_connections.insert(host, connection);
+
+    if (m_createdCallback) {
+        m_createdCallback(*connection);
+    }
+
+    if (master->mode() == RedisClient::Connection::Mode::Cluster) {
+        // Cluster replicas redirect reads to master until READONLY is sent
+        auto sendReadOnly = [connection]() { connection->cmd({"READONLY"}, connection.data(), -1, [](const RedisClient::Response &) {}, [](const QString &) {}); };
+        connect(connection.data(), &RedisClient::Connection::connected, this, sendReadOnly);
+        sendReadOnly();
+    }
+    return connection;
+}
+
+bool ReplicaRouter::isFresh(const Replica &replica) const {
+    return replica.online && replica.lag >= 0 && replica.lag <= static_cast<qlonglong>(m_maxLag);
+}
+
+bool ReplicaRouter::isPinned(const QByteArray &key) {
+    auto pin = m_pinnedKeys.find(key);
+    if (pin == m_pinnedKeys.end()) { return false; }
+
+    if (pin.value() > m_clock.elapsed()) { return true; }
+    m_pinnedKeys.erase(pin);
+    return false;
+}
+
+void ReplicaRouter::parseReplicationInfo(const QString &info) {
+    QList<Replica> replicas;
+    qlonglong masterOffset = -1;
+
+    // slave0:ip=10.0.0.2,port=6379,state=online,offset=1234,lag=0
+    for (const QString &line : info.split("\r\n", QString::SkipEmptyParts)) {
+        if (line.startsWith("master_repl_offset:")) {
+            masterOffset = line.section(':', 1).toLongLong();
+            continue;
+        }
+        if (!line.startsWith("slave") || !line.contains(":ip=")) { continue; }
+
+        QHash<QString, QString> fields;
+        for (const QString &field : line.section(':', 1).split(',')) {
+            fields.insert(field.section('=', 0, 0), field.section('=', 1));
+        }
+
+        Replica replica{{fields.value("ip"), fields.value("port").toInt()},
+                        fields.value("state") == "online",
+                        fields.value("lag", "-1").toLongLong(),
+                        fields.contains("offset") ? fields.value("offset").toLongLong() : -1};
+        replicas.append(replica);
+    }
+
+    for (Replica &replica : replicas) {
+        replica.offsetBehind = (masterOffset >= 0 && replica.offsetBehind >= 0) ? qMax(0LL, masterOffset - replica.offsetBehind) : -1;
+    }
+
+    std::stable_sort(replicas.begin(), replicas.end(), [](const Replica &a, const Replica &b) { return a.lag < b.lag; });
+
+    m_replicas = replicas;
+    m_slots.clear();
+}
+
+void ReplicaRouter::parseClusterSlots(const QVariantList &slots) {
+    QList<Replica> replicas;
+    QMap<int, SlotRange> ranges;
+
+    // [start, end, [master host, port, id], [replica host, port, id], ...]
+    for (const QVariant &item : slots) {
+        QVariantList range = item.toList();
+        if (range.size() < 3) { continue; }
+
+        SlotRange slotRange{range.at(1).toInt(), {}};
+        for (int i = 3; i < range.size(); ++i) {
+            QVariantList node = range.at(i).toList();
+            if (node.size() < 2) { continue; }
+
+            RedisClient::Connection::Host host{QString::fromUtf8(node.at(0).toByteArray()), node.at(1).toInt()};
+            slotRange.replicas.append(host);
+
+            // NOTE: CLUSTER SLOTS lists only replicas which are not marked as failed
+            bool known = std::any_of(replicas.begin(), replicas.end(), [&host](const Replica &r) { return r.host == host; });
+            if (known) { continue; }
+
+            // Lag is kept until INFO of the replica is refreshed
+            auto previous = std::find_if(m_replicas.begin(), m_replicas.end(), [&host](const Replica &r) { return r.host == host; });
+            replicas.append(previous != m_replicas.end() ? *previous : Replica{host, true, -1, -1});
+        }
+        ranges.insert(range.at(0).toInt(), slotRange);
+    }
+
+    m_replicas = replicas;
+    m_slots = ranges;
+}
+
+// CLUSTER SLOTS doesn't report lag, every replica reports time since last interaction with its master
+void ReplicaRouter::refreshClusterLag() {
+    for (const Replica &replica : m_replicas) {
+        RedisClient::Connection::Host host = replica.host;
+        auto connection = replicaConnection(host);
+        if (!connection) { continue; }
+
+        connection->cmd({"INFO", "replication"}, this, -1, [this, host](const RedisClient::Response &r) {
+            if (r.isErrorMessage()) { return; }
+            parseReplicaInfo(host, QString::fromUtf8(r.value().toByteArray()));
+            emit replicasUpdated();
+        }, [](const QString &) {});
+    }
+}
+
+void ReplicaRouter::parseReplicaInfo(const RedisClient::Connection::Host &host, const QString &info) {
+    auto replica = std::find_if(m_replicas.begin(), m_replicas.end(), [&host](const Replica &r) { return r.host == host; });
+    if (replica == m_replicas.end()) { return; }
+
+    // master_link_status:up
+    // master_last_io_seconds_ago:1
+    bool linkUp = false;
+    qlonglong lastIo = -1;
+    for (const QString &line : info.split("\r\n", QString::SkipEmptyParts)) {
+        if (line.startsWith("master_link_status:")) {
+            linkUp = line.section(':', 1) == "up";
+        } else if (line.startsWith("master_last_io_seconds_ago:")) {
+            lastIo = line.section(':', 1).toLongLong();
+        }
+    }
+
+    replica->online = linkUp;
+    replica->lag = linkUp ? lastIo : -1;
+
+    std::stable_sort(m_replicas.begin(), m_replicas.end(), [](const Replica &a, const Replica &b) { return a.lag < b.lag; });
+}
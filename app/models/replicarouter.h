@@ -0,0 +1,91 @@
+#pragma once
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMap>
+#include <QObject>
+#include <QSharedPointer>
+#include <QTimer>
+#include <functional>
+#include "connection.h"
+
+
+// Routes read-only commands of one server to its replicas.
+// Replicas are discovered with INFO replication (standalone and sentinel
+// masters) or CLUSTER SLOTS and refreshed periodically together with their
+// replication lag, lag of cluster replicas is read from INFO replication of
+// every replica. Router is attached to master connection as a child object,
+// commands which are not explicitly routed keep going to the master.
+// Keys written through the master are read from the master until replicas
+// within allowed lag have applied the write.
+class ReplicaRouter : public QObject {
+    Q_OBJECT
+
+public:
+    struct Replica {
+        RedisClient::Connection::Host host;
+        bool online;
+        qlonglong lag;              // seconds since last replication ack, -1 if unknown
+        qlonglong offsetBehind;     // bytes of replication stream not applied yet, -1 if unknown
+    };
+
+    static const int DEFAULT_REFRESH_INTERVAL = 10000;
+
+    typedef std::function<void(RedisClient::Connection &)> CreatedCallback;
+
+public:
+    ReplicaRouter(RedisClient::Connection *master, uint maxLag);
+
+    static ReplicaRouter *of(RedisClient::Connection *master);
+
+    // Replica connection for reading key, or master if no replica is fresh enough
+    static QSharedPointer<RedisClient::Connection> readConnection(QSharedPointer<RedisClient::Connection> master, const QByteArray &key);
+
+    // Reads of key go to master for max allowed lag after the key was written
+    static void pinToMaster(QSharedPointer<RedisClient::Connection> master, const QByteArray &key);
+
+    void setMaxLag(uint seconds) { m_maxLag = seconds; }
+
+    // Called for every new replica connection, e.g. to register logger
+    void setCreatedCallback(CreatedCallback callback) { m_createdCallback = callback; }
+
+    // Closes replica connections, they are reopened on demand
+    void closeConnections();
+
+    QList<Replica> replicas() const;
+
+    // Human readable lag of replicas for status line
+    QString staleness() const;
+
+public slots:
+    void refresh();
+
+signals:
+    void replicasUpdated();
+
+private:
+    struct SlotRange {
+        int end;
+        QList<RedisClient::Connection::Host> replicas;
+    };
+
+    RedisClient::Connection *master() const;
+    QSharedPointer<RedisClient::Connection> connectionFor(const QByteArray &key);
+    QSharedPointer<RedisClient::Connection> replicaConnection(const RedisClient::Connection::Host &host);
+    bool isFresh(const Replica &replica) const;
+    bool isPinned(const QByteArray &key);
+
+    void parseReplicationInfo(const QString &info);
+    void parseClusterSlots(const QVariantList &slots);
+    void refreshClusterLag();
+    void parseReplicaInfo(const RedisClient::Connection::Host &host, const QString &info);
+
+private:
+    uint m_maxLag;
+    QTimer m_refreshTimer;
+    QList<Replica> m_replicas;
+    QMap<int, SlotRange> m_slots;
+    QHash<RedisClient::Connection::Host, QSharedPointer<RedisClient::Connection>> m_connections;
+    CreatedCallback m_createdCallback;
+    QElapsedTimer m_clock;
+    QHash<QByteArray, qint64> m_pinnedKeys;     // key -> m_clock time when pin expires
+};
@@ -0,0 +1,85 @@
+#include "scancountcontroller.h"
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QtGlobal>
+
+namespace {
+    const double COST_SMOOTHING = 0.3;
+    const double ROUND_TRIP_DRIFT = 1.05;   // lets round trip estimate recover after network changes
+    const double MAX_STEP = 2.0;
+}
+
+
+ScanCountController::ScanCountController(QObject *parent, const QByteArray &family, long minCount, long maxCount,
+                                         uint targetLatencyMs)
+    : QObject(parent), m_count(1000), m_roundTripUs(-1), m_costPerItemUs(-1) {
+    setObjectName(QString::fromLatin1(family.toUpper()));
+    setBounds(minCount, maxCount, targetLatencyMs);
+}
+
+ScanCountController *ScanCountController::of(RedisClient::Connection *connection, const QByteArray &family) {
+    if (!connection) { return nullptr; }
+
+    auto controllers = connection->findChildren<ScanCountController *>(QString(), Qt::FindDirectChildrenOnly);
+    QString name = QString::fromLatin1(family.toUpper());
+    for (auto controller : controllers) {
+        if (controller->objectName() == name) { return controller; }
+    }
+
+    if (controllers.isEmpty()) {
+        return new ScanCountController(connection, family);
+    }
+    auto bounds = controllers.first();
+    return new ScanCountController(connection, family, bounds->m_minCount, bounds->m_maxCount, bounds->m_targetUs / 1000);
+}
+
+void ScanCountController::setBounds(RedisClient::Connection *connection, long minCount, long maxCount, uint targetLatencyMs) {
+    if (!connection) { return; }
+
+    // NOTE: SCAN controller keeps bounds for families which are created later
+    of(connection, "SCAN");
+    for (auto controller : connection->findChildren<ScanCountController *>(QString(), Qt::FindDirectChildrenOnly)) {
+        controller->setBounds(minCount, maxCount, targetLatencyMs);
+    }
+}
+
+void ScanCountController::setBounds(long minCount, long maxCount, uint targetLatencyMs) {
+    m_minCount = qMax(1L, minCount);
+    m_maxCount = qMax(m_minCount, maxCount);
+    m_targetUs = qMax(1u, targetLatencyMs) * 1000;
+    m_count = qBound(m_minCount, m_count, m_maxCount);
+}
+
+void ScanCountController::run(RedisClient::Connection *connection, const QList<QByteArray> &cmd, long count,
+                              QObject *owner, int db, std::function<void(const RedisClient::Response &)> callback,
+                              std::function<void(const QString &)> errback) {
+    QPointer<ScanCountController> self(this);
+    auto timer = QSharedPointer<QElapsedTimer>(new QElapsedTimer());
+
+    connection->cmd({"PING"}, owner, db, [timer](const RedisClient::Response &) { timer->start(); }, [](const QString &) {});
+    connection->cmd(cmd, owner, db, [self, count, timer, callback](const RedisClient::Response &r) {
+        if (self && timer->isValid()) {
+            self->record(count, timer->nsecsElapsed() / 1000);
+        }
+        callback(r);
+    }, errback);
+}
+
+void ScanCountController::record(long count, qint64 elapsedUs) {
+    if (count <= 0 || elapsedUs <= 0) { return; }
+
+    if (m_roundTripUs < 0 || elapsedUs < m_roundTripUs) {
+        m_roundTripUs = elapsedUs;
+    } else {
+        m_roundTripUs = qMin(m_roundTripUs * ROUND_TRIP_DRIFT, double(elapsedUs));
+    }
+
+    double serverUs = qMax(1.0, elapsedUs - m_roundTripUs);
+    double costPerItem = serverUs / count;
+    m_costPerItemUs = m_costPerItemUs < 0 ? costPerItem
+                                          : m_costPerItemUs + COST_SMOOTHING * (costPerItem - m_costPerItemUs);
+
+    double target = m_targetUs / m_costPerItemUs;
+    target = qBound(m_count / MAX_STEP, target, m_count * MAX_STEP);
+    m_count = qBound(m_minCount, static_cast<long>(target), m_maxCount);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <QObject>
+#include <QSharedPointer>
+#include <functional>
+#include "connection.h"
+
+
+// Adjusts COUNT of one SCAN command family (SCAN, HSCAN, SSCAN or ZSCAN) on one
+// connection toward target server time per call. Network round trip is
+// estimated as the fastest response seen recently and subtracted from measured
+// response time, the rest is treated as server time proportional to COUNT.
+// Every family has its own controller because cost per element differs, all of
+// them are attached to connection as child objects.
+class ScanCountController : public QObject {
+    Q_OBJECT
+
+public:
+    static const long DEFAULT_MIN_COUNT = 100;
+    static const long DEFAULT_MAX_COUNT = 50000;
+    static const uint DEFAULT_TARGET_LATENCY_MS = 25;
+
+public:
+    ScanCountController(QObject *parent, const QByteArray &family, long minCount = DEFAULT_MIN_COUNT,
+                        long maxCount = DEFAULT_MAX_COUNT, uint targetLatencyMs = DEFAULT_TARGET_LATENCY_MS);
+
+    // Returns controller of command family attached to connection, new controller
+    // takes bounds of existing ones
+    static ScanCountController *of(RedisClient::Connection *connection, const QByteArray &family);
+
+    // Bounds of all families on connection
+    static void setBounds(RedisClient::Connection *connection, long minCount, long maxCount, uint targetLatencyMs);
+
+    void setBounds(long minCount, long maxCount, uint targetLatencyMs);
+
+    long count() const { return m_count; }
+
+    // Sends SCAN family command with given COUNT and records its response time.
+    // Command keeps its place in the queue behind user commands. qredisclient
+    // doesn't report when command is written to socket, so PING is queued right
+    // before it and timer starts when PING response arrives, queue wait of
+    // the command is not recorded.
+    void run(RedisClient::Connection *connection, const QList<QByteArray> &cmd, long count, QObject *owner, int db,
+             std::function<void(const RedisClient::Response &)> callback, std::function<void(const QString &)> errback);
+
+    // Response time of call with given COUNT
+    void record(long count, qint64 elapsedUs);
+
+private:
+    long m_minCount;
+    long m_maxCount;
+    qint64 m_targetUs;
+    long m_count;
+    double m_roundTripUs;
+    double m_costPerItemUs;
+};
@@ -38,6 +38,16 @@ void ServerConfig::setNamespaceSeparator(QString ns) {
 
 
 
+bool ServerConfig::luaKeysLoading() const {
+    return param<bool>("lua_keys_loading", DEFAULT_LUA_KEYS_LOADING);
+}
+
+void ServerConfig::setLuaKeysLoading(bool enabled) {
+    setParam<bool>("lua_keys_loading", enabled);
+}
+
+
+
 uint ServerConfig::databaseScanLimit() const {
     return param<uint>("db_scan_limit", DEFAULT_DB_SCAN_LIMIT);
 }
@@ -48,6 +58,68 @@ void ServerConfig::setDatabaseScanLimit(uint limit) {
 
 
 
+uint ServerConfig::clusterScanConcurrency() const {
+    return param<uint>("cluster_scan_concurrency", DEFAULT_CLUSTER_SCAN_CONCURRENCY);
+}
+
+void ServerConfig::setClusterScanConcurrency(uint concurrency) {
+    setParam<uint>("cluster_scan_concurrency", concurrency);
+}
+
+uint ServerConfig::keysLoadingLimit() const {
+    return param<uint>("keys_loading_limit", DEFAULT_KEYS_LOADING_LIMIT);
+}
+
+void ServerConfig::setKeysLoadingLimit(uint limit) {
+    setParam<uint>("keys_loading_limit", limit);
+}
+
+
+
+uint ServerConfig::scanCountMin() const {
+    return param<uint>("scan_count_min", DEFAULT_SCAN_COUNT_MIN);
+}
+
+void ServerConfig::setScanCountMin(uint count) {
+    setParam<uint>("scan_count_min", count);
+}
+
+uint ServerConfig::scanCountMax() const {
+    return param<uint>("scan_count_max", DEFAULT_SCAN_COUNT_MAX);
+}
+
+void ServerConfig::setScanCountMax(uint count) {
+    setParam<uint>("scan_count_max", count);
+}
+
+uint ServerConfig::scanTargetLatency() const {
+    return param<uint>("scan_target_latency", DEFAULT_SCAN_TARGET_LATENCY);
+}
+
+void ServerConfig::setScanTargetLatency(uint ms) {
+    setParam<uint>("scan_target_latency", ms);
+}
+
+
+
+bool ServerConfig::readFromReplicas() const {
+    return param<bool>("read_from_replicas", DEFAULT_READ_FROM_REPLICAS);
+}
+
+void ServerConfig::setReadFromReplicas(bool enabled) {
+    setParam<bool>("read_from_replicas", enabled);
+}
+
+uint ServerConfig::replicaMaxLag() const {
+    return param<uint>("replica_max_lag", DEFAULT_REPLICA_MAX_LAG);
+}
+
+void ServerConfig::setReplicaMaxLag(uint seconds) {
+    setParam<uint>("replica_max_lag", seconds);
+}
+
+
+
 bool ServerConfig::useSshTunnel() const {
     return RedisClient::ConnectionConfig::useSshTunnel();
 }
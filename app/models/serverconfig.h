@@ -38,6 +38,14 @@ class ServerConfig : public RedisClient::ConnectionConfig {
     Q_PROPERTY(bool overrideClusterHost READ overrideClusterHost WRITE setClusterHostOverride)
     Q_PROPERTY(bool ignoreSSLErrors READ ignoreAllSslErrors WRITE setIgnoreAllSslErrors)
     Q_PROPERTY(uint databaseScanLimit READ databaseScanLimit WRITE setDatabaseScanLimit)
+    Q_PROPERTY(bool luaKeysLoading READ luaKeysLoading WRITE setLuaKeysLoading)
+    Q_PROPERTY(uint clusterScanConcurrency READ clusterScanConcurrency WRITE setClusterScanConcurrency)
+    Q_PROPERTY(uint keysLoadingLimit READ keysLoadingLimit WRITE setKeysLoadingLimit)
+    Q_PROPERTY(uint scanCountMin READ scanCountMin WRITE setScanCountMin)
+    Q_PROPERTY(uint scanCountMax READ scanCountMax WRITE setScanCountMax)
+    Q_PROPERTY(uint scanTargetLatency READ scanTargetLatency WRITE setScanTargetLatency)
+    Q_PROPERTY(bool readFromReplicas READ readFromReplicas WRITE setReadFromReplicas)
+    Q_PROPERTY(uint replicaMaxLag READ replicaMaxLag WRITE setReplicaMaxLag)
 
 
 public:
@@ -45,6 +53,13 @@ public:
     static const char DEFAULT_KEYS_GLOB_PATTERN = '*';
     static const bool DEFAULT_LUA_KEYS_LOADING = false;
     static const uint DEFAULT_DB_SCAN_LIMIT = 20;
+    static const uint DEFAULT_CLUSTER_SCAN_CONCURRENCY = 8;
+    static const uint DEFAULT_KEYS_LOADING_LIMIT = 10000;
+    static const uint DEFAULT_SCAN_COUNT_MIN = 100;
+    static const uint DEFAULT_SCAN_COUNT_MAX = 50000;
+    static const uint DEFAULT_SCAN_TARGET_LATENCY = 25;
+    static const bool DEFAULT_READ_FROM_REPLICAS = false;
+    static const uint DEFAULT_REPLICA_MAX_LAG = 10;
 
 public:
     ServerConfig(const QString &host = "127.0.0.1", const QString &auth = "", const uint port = DEFAULT_REDIS_PORT, const QString &name = "");
@@ -57,11 +72,35 @@ public:
     QString namespaceSeparator() const;
     void setNamespaceSeparator(QString);
 
+    // Group namespaces on the server side with Lua script
+    bool luaKeysLoading() const;
     void setLuaKeysLoading(bool);
 
     uint databaseScanLimit() const;
     void setDatabaseScanLimit(uint limit);
 
+    // 0 - scan cluster masters one by one
+    uint clusterScanConcurrency() const;
+    void setClusterScanConcurrency(uint concurrency);
+
+    // Keys loaded before scanning pauses, 0 - load all keys
+    uint keysLoadingLimit() const;
+    void setKeysLoadingLimit(uint limit);
+
+    // Bounds of adaptive SCAN COUNT and target server time per call (ms)
+    uint scanCountMin() const;
+    void setScanCountMin(uint count);
+    uint scanCountMax() const;
+    void setScanCountMax(uint count);
+    uint scanTargetLatency() const;
+    void setScanTargetLatency(uint ms);
+
+    // Send read-only commands to replicas which are at most replicaMaxLag seconds behind
+    bool readFromReplicas() const;
+    void setReadFromReplicas(bool enabled);
+    uint replicaMaxLag() const;
+    void setReplicaMaxLag(uint seconds);
+
     Q_INVOKABLE bool useSshTunnel() const;
 
     QWeakPointer<TreeOperations> owner() const;
@@ -2,6 +2,7 @@
 
 #include "asyncfuture.h"
 #include "redisclient.h"
+#include <QMutexLocker>
 #include <QRegExp>
 #include <QRegularExpression>
 #include <QRegularExpressionMatchIterator>
@@ -10,34 +11,61 @@
 #include <algorithm>
 
 #include "app/events.h"
+#include "app/models/clusterslotrouter.h"
+#include "app/models/replicarouter.h"
+#include "app/models/scancountcontroller.h"
 #include "modules/connections-tree/items/serveritem.h"
 #include "modules/connections-tree/items/databaseitem.h"
 #include "modules/connections-tree/items/namespaceitem.h"
 #include "modules/connections-tree/keysrendering.h"
 
+namespace {
+    // Glob metacharacters of key names are matched literally
+    QByteArray escapeGlob(const QByteArray &value) {
+        QByteArray result;
+        result.reserve(value.size());
+        for (char c : value) {
+            if (c == '*' || c == '?' || c == '[' || c == ']' || c == '\\') {
+                result.append('\\');
+            }
+            result.append(c);
+        }
+        return result;
+    }
+}
 
 
 TreeOperations::TreeOperations(const ServerConfig &config, QSharedPointer<Events> events) : m_events(events), m_dbCount(0), m_connectionMode(RedisClient::Connection::Mode::Normal), m_config(config){
   m_connection = QSharedPointer<RedisClient::Connection>(new RedisClient::Connection(config));
   m_events->registerLoggerForConnection(*m_connection);
+  updateScanCount(*m_connection);
+  updateReadRouting(*m_connection);
+  updateClusterRouting(*m_connection);
+  m_pool.reset(m_connection);
+  // NOTE(u_glide): Use "clean" connection wihout logger for bulk operations for better performance
+  m_pool.setCreatedCallback([this](ConnectionPool::Lane lane, RedisClient::Connection& c) {
+    if (lane != ConnectionPool::Lane::Bulk) { m_events->registerLoggerForConnection(c); }
+    updateScanCount(c);
+  });
+  QObject::connect(m_events.data(), &Events::loadMoreKeys, this, [this](QSharedPointer<RedisClient::Connection> c, int dbIndex) {
+    if (c == m_connection) { loadMoreNamespaceItems(static_cast<uint>(dbIndex)); }
+  });
 }
 
 TreeOperations::~TreeOperations() {
+  cancelKeyScanners();
   if (m_connection) {
     m_connection->disconnect();
     m_connection->deleteLater();
   }
 }
 
-void TreeOperations::loadDatabases(QSharedPointer<AsyncFuture::Deferred<void>> d, std::function<void(RedisClient::DatabaseList, const QString&)> callback) {
-  if (!d) {return;}
-  auto connection = m_connection->clone(false);
+void TreeOperations::loadDatabases(QSharedPointer<AsyncFuture::Deferred<void>> d, QSharedPointer<RedisClient::Connection> connection, std::function<void(RedisClient::DatabaseList, const QString&)> callback) {
+  if (!d || !connection) {return;}
 
   d->onCanceled([connection](){
       QtConcurrent::run([connection]() { if (connection) connection->disconnect(); });
   });
-  // 事件，注册日志
-  m_events->registerLoggerForConnection(*connection);
 
   if (!connect(connection)) {
     return callback(RedisClient::DatabaseList(), QString("Cannot connect to redis-server"));
@@ -140,27 +168,291 @@ bool TreeOperations::connect(QSharedPointer<RedisClient::Connection> c) {
 
 
 
+void TreeOperations::updateScanCount(RedisClient::Connection &c) {
+    ScanCountController::setBounds(&c, m_config.scanCountMin(), m_config.scanCountMax(), m_config.scanTargetLatency());
+}
+
+// 只读命令发送到replica，SSH隧道无法访问replica地址
+void TreeOperations::updateReadRouting(RedisClient::Connection &c) {
+    ReplicaRouter *router = ReplicaRouter::of(&c);
+    bool enabled = m_config.readFromReplicas() && !m_config.useSshTunnel();
+
+    if (enabled && !router) {
+        router = new ReplicaRouter(&c, m_config.replicaMaxLag());
+        router->setCreatedCallback([this](RedisClient::Connection& replica) {
+            m_events->registerLoggerForConnection(replica);
+            updateScanCount(replica);
+        });
+    } else if (enabled) {
+        router->setMaxLag(m_config.replicaMaxLag());
+    } else if (router) {
+        router->closeConnections();
+        router->setParent(nullptr);
+        router->deleteLater();
+    }
+}
+
+// Replica and cluster node connections of routers aren't pooled, they are closed before pooled connections
+void TreeOperations::closeRoutedConnections() {
+    for (auto connection : m_pool.connections()) {
+        ReplicaRouter *replicaRouter = ReplicaRouter::of(connection.data());
+        if (replicaRouter) {
+            replicaRouter->closeConnections();
+        }
+
+        ClusterSlotRouter *clusterRouter = ClusterSlotRouter::of(connection.data());
+        if (clusterRouter) {
+            clusterRouter->closeConnections();
+        }
+    }
+}
+
+// Key commands go to slot owner directly, SSH隧道只能访问入口节点
+void TreeOperations::updateClusterRouting(RedisClient::Connection &c) {
+    ClusterSlotRouter *router = ClusterSlotRouter::of(&c);
+    bool enabled = !m_config.useSshTunnel();
+
+    if (enabled && !router) {
+        new ClusterSlotRouter(&c);
+    } else if (!enabled && router) {
+        router->closeConnections();
+        router->setParent(nullptr);
+        router->deleteLater();
+    }
+}
+
+QSharedPointer<RedisClient::Connection> TreeOperations::scanConnection() {
+    auto connection = m_pool.connection(ConnectionPool::Lane::Scan);
+    updateReadRouting(*connection);
+    return connection;
+}
+
+
+
 void TreeOperations::requestBulkOperation(ConnectionsTree::AbstractNamespaceItem& ns, BulkOperations::Manager::Operation op, BulkOperations::AbstractOperation::OperationCallback callback) {
     // 格式，并使用正则表达式匹配
     QString pattern = QString("%1%2*").arg(QString::fromUtf8(ns.getFullPath())).arg(ns.getFullPath().size() > 0 ? m_config.namespaceSeparator() : "");
     QRegExp filter(pattern, Qt::CaseSensitive, QRegExp::Wildcard);
 
-    // NOTE(u_glide): Use "clean" connection wihout logger here for better performance
-    emit m_events->requestBulkOperation(m_connection->clone(), ns.getDbIndex(), op, filter, callback);
+    // NOTE: bulk operations manager runs one job at a time, jobs share pooled connection
+    emit m_events->requestBulkOperation(m_pool.connection(ConnectionPool::Lane::Bulk), ns.getDbIndex(), op, filter, callback);
 }
 
 
 QFuture<void> TreeOperations::getDatabases(std::function<void(RedisClient::DatabaseList, const QString&)> callback) {
     m_dbScanOp = QSharedPointer<AsyncFuture::Deferred<void>>(new AsyncFuture::Deferred<void>());
-    QtConcurrent::run(this, &TreeOperations::loadDatabases, m_dbScanOp, callback);
+
+    // NOTE: connection is taken here to create it in the main thread. Cancelling
+    // the load disconnects it, key scans reconnect it on demand
+    auto connection = m_pool.connection(ConnectionPool::Lane::Scan);
+    QtConcurrent::run(this, &TreeOperations::loadDatabases, m_dbScanOp, connection, callback);
     return m_dbScanOp->future();
 }
 
 
 void TreeOperations::loadNamespaceItems(uint dbIndex, const QString& filter, std::function<void(const RedisClient::Connection::RawKeysList& keylist, const QString& err)>callback) {
+    QString keyPattern = updateFilterHistory(filter);
+
+    // "type:<name> <pattern>" 过滤器：TYPE交给服务器过滤
+    QString scanPattern = keyPattern;
+    QByteArray keyType = KeyScanner::takeTypeFilter(scanPattern);
+    if (scanPattern.isEmpty()) { scanPattern = m_config.keysPattern(); }
+
+    auto connection = scanConnection();
+    if (!connect(connection)) return;
+
+    auto processErr = [callback](const QString& err) {
+        return callback(RedisClient::Connection::RawKeysList(), QCoreApplication::translate("RDM", "Cannot load keys: %1").arg(err));
+    };
+
+    try {
+        if (connection->mode() == RedisClient::Connection::Mode::Cluster && m_config.clusterScanConcurrency() == 0) {
+            m_namespaceTrees.remove(dbIndex);
+            m_keysTargets.remove(dbIndex);
+            // NOTE: legacy cluster loading doesn't support TYPE filter
+            connection->getClusterKeys(callback, scanPattern);        // 获取cluster的keys
+        } else {
+            // 每个批次到达后立即交给回调，达到keysLoadingLimit时暂停，loadMoreNamespaceItems()继续加载
+            auto target = QSharedPointer<KeyScanner::BatchCallback>(new KeyScanner::BatchCallback(streamKeys(dbIndex, callback)));
+            m_keysTargets.insert(dbIndex, target);
+            scanKeys(dbIndex, connection, scanPattern, keyType, buildNamespaceTree(dbIndex, keyPattern, target));
+        }
+    } catch (const RedisClient::Connection::Exception& error) {
+        processErr(error.what());
+    }
+}
+
+bool TreeOperations::loadMoreNamespaceItems(uint dbIndex) {
+    if (!m_keysTargets.contains(dbIndex) || !hasMoreNamespaceItems(dbIndex)) {
+        return false;
+    }
+
+    m_keyScanners[dbIndex]->loadMore(m_config.keysLoadingLimit());
+    return true;
+}
+
+bool TreeOperations::hasMoreNamespaceItems(uint dbIndex) const {
+    auto scanner = m_keyScanners.value(dbIndex);
+    return scanner && scanner->hasMore();
+}
+
+// 批次不累积，空批次只在扫描暂停或结束时交给回调
+KeyScanner::BatchCallback TreeOperations::streamKeys(uint dbIndex, KeysCallback callback) {
+    auto self = sharedFromThis().toWeakRef();
+    return [self, dbIndex, callback](const RedisClient::Connection::RawKeysList &batch, const QString &err, bool finished) {
+        if (!batch.isEmpty() || finished) {
+            callback(batch, err);
+        }
+
+        auto operations = self.toStrongRef();
+        if (finished && err.isEmpty() && operations && operations->hasMoreNamespaceItems(dbIndex)) {
+            emit operations->m_events->keysLoadingPaused(operations->m_connection, static_cast<int>(dbIndex));
+        }
+    };
+}
+
+// 批次在线程池中拆分并插入树，插入完成后按到达顺序交给当前的target
+KeyScanner::BatchCallback TreeOperations::buildNamespaceTree(uint dbIndex, const QString &pattern, QSharedPointer<KeyScanner::BatchCallback> target) {
+    QByteArray separator = m_config.namespaceSeparator().toUtf8();
+    auto tree = QSharedPointer<NamespaceTree>(new NamespaceTree(separator, pattern));
+    m_namespaceTrees.insert(dbIndex, tree);
+
+    struct PendingBatch {
+        QFuture<void> insert;
+        RedisClient::Connection::RawKeysList keys;
+        QString err;
+        bool finished;
+    };
+    auto pending = QSharedPointer<QList<PendingBatch>>(new QList<PendingBatch>());
+    auto self = sharedFromThis().toWeakRef();
+
+    auto mergeReady = [self, dbIndex, tree, pending, target]() {
+        auto operations = self.toStrongRef();
+        if (!operations || operations->m_namespaceTrees.value(dbIndex) != tree) {
+            pending->clear();
+            return;
+        }
+
+        while (!pending->isEmpty() && pending->first().insert.isFinished()) {
+            PendingBatch batch = pending->takeFirst();
+            if (batch.finished) {
+                tree->complete = batch.err.isEmpty() && !operations->hasMoreNamespaceItems(dbIndex);
+            }
+            if (*target) { (*target)(batch.keys, batch.err, batch.finished); }
+        }
+    };
+
+    // NOTE: segments are interned in the worker thread, GUI thread takes the lock only to read the tree
+    return [tree, pending, separator, mergeReady](const RedisClient::Connection::RawKeysList &keys, const QString &err, bool finished) {
+        QFuture<void> insert = QtConcurrent::run([tree, keys, separator]() {
+            NamespaceSplitter::Result split = NamespaceSplitter::split(keys, separator);
+            QMutexLocker locker(&tree->lock);
+            tree->trie.insert(keys, split);
+        });
+        pending->append({insert, keys, err, finished});
+        AsyncFuture::observe(insert).subscribe([mergeReady]() { mergeReady(); });
+    };
+}
+
+void TreeOperations::loadNamespaceLevel(uint dbIndex, const QByteArray &prefix, const QString &filter, RedisClient::Connection::NamespaceItemsCallback callback) {
+    // NOTE: SCAN takes only one pattern, prefix pattern is used if filter matches all keys,
+    // otherwise keys outside of prefix are skipped while grouping
+    QString levelFilter = filter.isEmpty() ? m_config.keysPattern() : filter;
+    QString scanPattern = levelFilter;
+    QByteArray type = KeyScanner::takeTypeFilter(scanPattern);
+    QByteArray pattern = (scanPattern.isEmpty() ? m_config.keysPattern() : scanPattern).toUtf8();
+    if (!prefix.isEmpty() && pattern == "*") {
+        pattern = escapeGlob(prefix + m_config.namespaceSeparator().toUtf8()) + "*";
+    }
+
+    cancelNamespaceLevel();
+
+    // 完整加载的keys树直接在客户端分组，不访问服务器
+    auto tree = m_namespaceTrees.value(dbIndex);
+    if (tree && tree->complete && tree->pattern == levelFilter) {
+        QMutexLocker locker(&tree->lock);
+        NamespaceTrie::NodeId node = tree->trie.find(prefix);
+        return callback(node == NamespaceTrie::INVALID_NODE ? RedisClient::Connection::NamespaceItems() : tree->trie.items(node), QString());
+    }
+
+    auto connection = scanConnection();
+    if (!connect(connection)) return;
+
+    auto self = sharedFromThis().toWeakRef();
+    auto loadOnClient = [self, dbIndex, connection, prefix, pattern, type, callback]() {
+        auto operations = self.toStrongRef();
+        if (operations) { operations->groupNamespaceLevel(dbIndex, connection, prefix, pattern, type, callback); }
+    };
+
+    // NOTE: script can scan only one node and doesn't filter by type, such keys are grouped on the client
+    if (!m_config.luaKeysLoading() || !type.isEmpty() || connection->mode() == RedisClient::Connection::Mode::Cluster) {
+        return loadOnClient();
+    }
+
+    m_namespaceAggregator = QSharedPointer<NamespaceAggregator>(new NamespaceAggregator(connection, m_config.namespaceSeparator(), static_cast<int>(dbIndex)), &QObject::deleteLater);
+    m_namespaceAggregator->load(prefix, pattern, [callback, loadOnClient](const RedisClient::Connection::NamespaceItems &items, const QString &err) {
+        // 服务器禁用了脚本（如 NOPERM），改为客户端分组
+        if (!err.isEmpty()) {
+            return loadOnClient();
+        }
+        callback(items, err);
+    });
+}
+
+// 客户端分组：扫描匹配的keys，prefix下的keys插入临时trie
+void TreeOperations::groupNamespaceLevel(uint dbIndex, QSharedPointer<RedisClient::Connection> c, const QByteArray &prefix, const QByteArray &pattern, const QByteArray &type, RedisClient::Connection::NamespaceItemsCallback callback) {
+    QByteArray separator = m_config.namespaceSeparator().toUtf8();
+    QByteArray levelPrefix = prefix.isEmpty() ? QByteArray() : prefix + separator;
+    auto level = QSharedPointer<NamespaceTrie>(new NamespaceTrie(separator));
+
+    KeyScanner::BatchCallback group = [level, prefix, levelPrefix, callback](const RedisClient::Connection::RawKeysList &keys, const QString &err, bool finished) {
+        for (const QByteArray &key : keys) {
+            if (key.startsWith(levelPrefix)) { level->insert(key); }
+        }
+        if (!finished) { return; }
+
+        if (!err.isEmpty()) {
+            return callback(RedisClient::Connection::NamespaceItems(), err);
+        }
+
+        NamespaceTrie::NodeId node = level->find(prefix);
+        callback(node == NamespaceTrie::INVALID_NODE ? RedisClient::Connection::NamespaceItems() : level->items(node), QString());
+    };
+
+    if (c->mode() == RedisClient::Connection::Mode::Cluster) {
+        m_levelClusterScanner = QSharedPointer<ClusterKeysScanner>(new ClusterKeysScanner(c, m_pool, pattern, m_config.clusterScanConcurrency()), &QObject::deleteLater);
+        m_levelClusterScanner->setTypeFilter(type);
+        m_levelClusterScanner->start(group);
+        return;
+    }
+
+    auto reader = ReplicaRouter::readConnection(c, QByteArray());
+    m_levelScanner = QSharedPointer<KeyScanner>(new KeyScanner(reader, pattern, static_cast<int>(dbIndex)), &QObject::deleteLater);
+    m_levelScanner->setTypeFilter(type);
+    m_levelScanner->start(group);
+}
+
+void TreeOperations::cancelNamespaceLevel() {
+    if (m_namespaceAggregator) {
+        m_namespaceAggregator->cancel();
+        m_namespaceAggregator.clear();
+    }
+    if (m_levelClusterScanner) {
+        m_levelClusterScanner->cancel();
+        m_levelClusterScanner.clear();
+    }
+    if (m_levelScanner) {
+        m_levelScanner->cancel();
+        m_levelScanner.clear();
+    }
+}
+
+
+
+// 从历史记录中查询 QVariantMap m_filterHistory，返回实际使用的pattern
+QString TreeOperations::updateFilterHistory(const QString &filter) {
     QString keyPattern = filter.isEmpty() ? m_config.keysPattern() : filter;
 
-    //从历史记录中查询 QVariantMap m_filterHistory
     if (m_filterHistory.contains(keyPattern)) {
         m_filterHistory[keyPattern] = m_filterHistory[keyPattern].toInt() + 1;
     } else {
@@ -169,34 +461,85 @@ void TreeOperations::loadNamespaceItems(uint dbIndex, const QString& filter, std
     m_config.setFilterHistory(m_filterHistory);
     emit filterHistoryUpdated();
 
-    if (!connect(m_connection)) return;
+    return keyPattern;
+}
 
-    auto processErr = [callback](const QString& err) {
-        return callback(RedisClient::Connection::RawKeysList(), QCoreApplication::translate("RDM", "Cannot load keys: %1").arg(err));
+void TreeOperations::scanKeys(uint dbIndex, QSharedPointer<RedisClient::Connection> c, const QString &pattern, const QByteArray &type, KeyScanner::BatchCallback callback) {
+    // 正在进行或已暂停的扫描被取消
+    auto current = m_keyScanners.take(dbIndex);
+    if (current) {
+        current->cancel();
+    }
+    if (m_clusterKeysScanner) {
+        m_clusterKeysScanner->cancel();
+        m_clusterKeysScanner.clear();
+    }
+
+    // 新的更窄的过滤条件：在客户端过滤上次扫描缓存的keys
+    RedisClient::Connection::RawKeysList keys;
+    if (!m_filterCache.contains(dbIndex, pattern, type) && m_filterCache.refilter(dbIndex, pattern, type, keys)) {
+        return callback(keys, QString(), true);
+    }
+
+    // 重新加载或其他过滤条件：缓存的keys可能已经过期，总是重新扫描
+    m_filterCache.invalidate(dbIndex);
+    auto entry = m_filterCache.insert(dbIndex, pattern, type);
+
+    // 并发获取所有master节点的keys
+    // NOTE: keys limit is not applied in cluster mode, every master node has its own cursor
+    if (c->mode() == RedisClient::Connection::Mode::Cluster) {
+        m_clusterKeysScanner = QSharedPointer<ClusterKeysScanner>(new ClusterKeysScanner(c, m_pool, pattern.toUtf8(), m_config.clusterScanConcurrency()), &QObject::deleteLater);
+        m_clusterKeysScanner->setTypeFilter(type);
+        m_clusterKeysScanner->start(cacheBatches(entry, callback));
+        return;
+    }
+
+    auto reader = ReplicaRouter::readConnection(c, QByteArray());
+    auto scanner = QSharedPointer<KeyScanner>(new KeyScanner(reader, pattern.toUtf8(), static_cast<int>(dbIndex), KeyScanner::ADAPTIVE_SCAN_COUNT, m_config.keysLoadingLimit()), &QObject::deleteLater);
+    scanner->setTypeFilter(type);
+    entry->scanner = scanner;
+    m_keyScanners.insert(dbIndex, scanner);
+    scanner->start(cacheBatches(entry, callback));
+}
+
+KeyScanner::BatchCallback TreeOperations::cacheBatches(QSharedPointer<KeyFilterCache::Entry> entry, KeyScanner::BatchCallback callback) {
+    auto self = sharedFromThis().toWeakRef();
+    return [self, entry, callback](const RedisClient::Connection::RawKeysList &keys, const QString &err, bool finished) {
+        auto operations = self.toStrongRef();
+        if (operations && entry->valid) {
+            if (!err.isEmpty()) {
+                operations->m_filterCache.remove(entry);
+            } else {
+                operations->m_filterCache.append(entry, keys);
+                entry->complete = finished && (!entry->scanner || entry->scanner->isFinished());
+            }
+        }
+        callback(keys, err, finished);
     };
+}
 
-    // 如果是cluster模式，则获取clusterKeys，否则执行cmd的 ping 命令
-    try {
-        if (m_connection->mode() == RedisClient::Connection::Mode::Cluster) {
-            m_connection->getClusterKeys(callback, keyPattern);            // 获取cluster的keys
-    } else {
-            m_connection->cmd({"ping"}, this, dbIndex, [this, callback, keyPattern, processErr](const RedisClient::Response& r) {
-                if (r.isErrorMessage()) {
-                    return processErr(r.value().toString());
-                }
-                m_connection->getDatabaseKeys(callback, keyPattern, -1);   // 获取database的key
-            },
-            [processErr](const QString& err) { return processErr(err); });
+void TreeOperations::cancelKeyScanners() {
+    cancelNamespaceLevel();
+    if (m_clusterKeysScanner) {
+        m_clusterKeysScanner->cancel();
+        m_clusterKeysScanner.clear();
     }
-    } catch (const RedisClient::Connection::Exception& error) {
-        processErr(error.what());
+    for (auto scanner : m_keyScanners) {
+        scanner->cancel();
     }
+    m_keyScanners.clear();
+    m_keysTargets.clear();
 }
 
 
 
 
-void TreeOperations::disconnect() { m_connection->disconnect(); }
+void TreeOperations::disconnect() {
+    cancelKeyScanners();
+    closeRoutedConnections();
+    m_pool.disconnect();
+    m_connection->disconnect();
+}
 
 void TreeOperations::resetConnection() {
     auto oldConnection = m_connection;
@@ -215,8 +558,16 @@ QSharedPointer<RedisClient::Connection> TreeOperations::connection() {
     return m_connection;
 }
 void TreeOperations::setConnection(QSharedPointer<RedisClient::Connection> c) {
+    cancelKeyScanners();
+    closeRoutedConnections();
+    m_namespaceTrees.clear();
+    m_filterCache.clear();
     m_connection = c;
     m_events->registerLoggerForConnection(*c);
+    updateScanCount(*c);
+    updateReadRouting(*c);
+    updateClusterRouting(*c);
+    m_pool.reset(c);
 }
 
 
@@ -249,7 +600,10 @@ void TreeOperations::openConsoleTab(int dbIndex) {
 }
 
 void TreeOperations::openNewKeyDialog(int dbIndex, std::function<void()> callback, QString keyPrefix) {
-    emit m_events->newKeyDialog(m_connection, callback, dbIndex, keyPrefix);
+    emit m_events->newKeyDialog(m_connection, [this, dbIndex, callback]() {
+        m_filterCache.invalidate(static_cast<uint>(dbIndex));
+        callback();
+    }, dbIndex, keyPrefix);
 }
 
 void TreeOperations::openServerStats() {
@@ -258,27 +612,43 @@ void TreeOperations::openServerStats() {
 
 
 void TreeOperations::notifyDbWasUnloaded(int dbIndex) {
+    auto scanner = m_keyScanners.take(static_cast<uint>(dbIndex));
+    if (scanner && scanner->isRunning()) {
+        scanner->cancel();
+    }
+    m_namespaceTrees.remove(static_cast<uint>(dbIndex));
+    m_keysTargets.remove(static_cast<uint>(dbIndex));
     emit m_events->closeDbKeys(m_connection, dbIndex);
 }
 
 void TreeOperations::deleteDbKey(ConnectionsTree::KeyItem& key, std::function<void(const QString&)> callback) {
+    auto onKeyRemoved = [this, &key]() {
+        key.setRemoved();
+        auto tree = m_namespaceTrees.value(key.getDbIndex());
+        if (tree) {
+            QMutexLocker locker(&tree->lock);
+            tree->trie.remove(key.getFullPath());
+        }
+        m_filterCache.removeKey(key.getDbIndex(), key.getFullPath());
+        QRegExp filter(key.getFullPath(), Qt::CaseSensitive, QRegExp::Wildcard);
+        if (m_events){ m_events->closeDbKeys(m_connection, key.getDbIndex(), filter); }
+    };
+    auto onError = [this, callback](const QString& err) {
+        QString errorMsg = QCoreApplication::translate("RDM", "Delete key error: %1").arg(err);
+        callback(errorMsg);
+        if (m_events) { m_events->error(errorMsg); }
+    };
+
     m_connection->cmd({"DEL", key.getFullPath()}, this, key.getDbIndex(),
-                      [this, &key](RedisClient::Response) {
-                            key.setRemoved();
-                            QRegExp filter(key.getFullPath(), Qt::CaseSensitive, QRegExp::Wildcard);
-                            if (m_events){ m_events->closeDbKeys(m_connection, key.getDbIndex(), filter); }
-                       },
-                      [this, callback](const QString& err) {
-                            QString errorMsg = QCoreApplication::translate("RDM", "Delete key error: %1").arg(err);
-                            callback(errorMsg);
-                            if (m_events) { m_events->error(errorMsg); }
-                       });
+                      [onKeyRemoved](RedisClient::Response) { onKeyRemoved(); },
+                      onError);
 }
 
 void TreeOperations::deleteDbKeys(ConnectionsTree::DatabaseItem& db) {
     auto self = sharedFromThis().toWeakRef();
     requestBulkOperation(db, BulkOperations::Manager::Operation::DELETE_KEYS, [self, this, &db](QRegExp filter, int, const QStringList&) {
         if (!self) { return; }
+        m_filterCache.invalidate(db.getDbIndex());
         db.reload();
         if (m_events) { emit m_events->closeDbKeys(m_connection, db.getDbIndex(), filter); }
       });
@@ -288,6 +658,7 @@ void TreeOperations::deleteDbNamespace(ConnectionsTree::NamespaceItem& ns) {
     auto self = sharedFromThis().toWeakRef();
     requestBulkOperation(ns, BulkOperations::Manager::Operation::DELETE_KEYS, [this, self, &ns](QRegExp filter, int, const QStringList&) {
         if (!self) { return; }
+        m_filterCache.invalidate(ns.getDbIndex());
         ns.setRemoved();
         if (m_events) { emit m_events->closeDbKeys(m_connection, ns.getDbIndex(), filter); }
     });
@@ -304,10 +675,15 @@ void TreeOperations::copyKeys(ConnectionsTree::AbstractNamespaceItem& ns) {
 }
 
 void TreeOperations::importKeysFromRdb(ConnectionsTree::DatabaseItem& db) {
-    emit m_events->requestBulkOperation(m_connection->clone(), db.getDbIndex(), BulkOperations::Manager::Operation::IMPORT_RDB_KEYS, QRegExp(".*"), [&db](QRegExp, int, const QStringList&) { db.reload(); });
+    emit m_events->requestBulkOperation(m_pool.connection(ConnectionPool::Lane::Bulk), db.getDbIndex(), BulkOperations::Manager::Operation::IMPORT_RDB_KEYS, QRegExp(".*"), [this, &db](QRegExp, int, const QStringList&) {
+        m_filterCache.invalidate(db.getDbIndex());
+        db.reload();
+    });
 }
 
 void TreeOperations::flushDb(int dbIndex, std::function<void(const QString&)> callback) {
+    m_filterCache.invalidate(static_cast<uint>(dbIndex));
+
     try {
         m_connection->flushDbKeys(dbIndex, callback);
     } catch (const RedisClient::Connection::Exception& e) {
@@ -340,6 +716,22 @@ void TreeOperations::openKeyIfExists(const QByteArray& fullPath, QSharedPointer<
 }
 
 void TreeOperations::getUsedMemory(const QList<QByteArray>& keys, int dbIndex, std::function<void(qlonglong)> result, std::function<void(qlonglong)> progress) {
+    // NOTE: keys of one request may belong to different cluster nodes
+    auto router = ClusterSlotRouter::of(m_connection.data());
+    if (router && router->isActive()) {
+        router->executePerKey({"MEMORY", "USAGE"}, keys, dbIndex, this, [this, progress, result](const QVariantList& replies, const QString& err) {
+            if (!err.isEmpty()) {
+                m_events->error(QCoreApplication::translate("RDM", "Cannot determine amount of used memory by key: %1").arg(err));
+            }
+
+            qlonglong totalMemory = 0;
+            for (const QVariant& reply : replies) { totalMemory += reply.toLongLong(); }
+            progress(totalMemory);
+            result(totalMemory);
+        });
+        return;
+    }
+
     QList<QList<QByteArray>> commands;
 
     for (int index = 0; index < keys.size(); ++index) {
@@ -350,7 +742,9 @@ void TreeOperations::getUsedMemory(const QList<QByteArray>& keys, int dbIndex, s
     auto processedResponses = QSharedPointer<int>(new int(0));
     auto totalMemory = QSharedPointer<qlonglong>(new qlonglong(0));
 
-    m_connection->pipelinedCmd(commands, this, dbIndex, [this, expectedResponses, processedResponses, totalMemory, progress, result](RedisClient::Response r, QString err) {
+    // NOTE: only standalone reads are routed to replicas
+    auto reader = m_connectionMode == RedisClient::Connection::Mode::Cluster ? m_connection : ReplicaRouter::readConnection(m_connection, QByteArray());
+    reader->pipelinedCmd(commands, this, dbIndex, [this, expectedResponses, processedResponses, totalMemory, progress, result](RedisClient::Response r, QString err) {
         if (!err.isEmpty()) {
             QString errorMsg = QCoreApplication::translate("RDM", "Cannot determine amount of used memory by key: %1").arg(err);
             m_events->error(errorMsg);
@@ -396,7 +790,16 @@ ServerConfig TreeOperations::config() {
 void TreeOperations::setConfig(const ServerConfig &c) {
     m_config = c;
     m_config.setOwner(sharedFromThis().toWeakRef());
+    // NOTE: replica and node connections are reopened with new config and scan bounds
+    closeRoutedConnections();
     m_connection->setConnectionConfig(m_config);
+    m_pool.setConnectionConfig(m_config);
+    for (auto connection : m_pool.connections()) {
+        updateScanCount(*connection);
+    }
+    updateReadRouting(*m_connection);
+    updateReadRouting(*m_pool.connection(ConnectionPool::Lane::Scan));
+    updateClusterRouting(*m_connection);
     emit configUpdated();
 }
 
@@ -1,8 +1,15 @@
 ﻿#pragma once
 #include <QEnableSharedFromThis>
+#include <QMutex>
 #include <QObject>
 #include <QSharedPointer>
 #include <functional>
+#include "app/models/clusterkeysscanner.h"
+#include "app/models/connectionpool.h"
+#include "app/models/keyfiltercache.h"
+#include "app/models/keyscanner.h"
+#include "app/models/namespaceaggregator.h"
+#include "app/models/namespacetrie.h"
 #include "app/models/serverconfig.h"
 #include "modules/bulk-operations/bulkoperationsmanager.h"
 #include "modules/connections-tree/operations.h"
@@ -19,13 +26,25 @@ namespace ConnectionsTree {
 class TreeOperations : public QObject, public ConnectionsTree::Operations, public QEnableSharedFromThis<TreeOperations> {
     Q_OBJECT
 public:
+    typedef std::function<void(const RedisClient::Connection::RawKeysList &keylist, const QString &err)> KeysCallback;
+
     TreeOperations(const ServerConfig &config, QSharedPointer<Events> events);
     ~TreeOperations();
 
     QFuture<void> getDatabases(std::function<void (RedisClient::DatabaseList, const QString &)>) override;
 
+    // Callback gets every SCAN batch as it arrives, batches are not kept after delivery.
+    // Scanning pauses after keysLoadingLimit keys and Events::keysLoadingPaused is emitted.
     void loadNamespaceItems(uint dbIndex, const QString &filter, std::function<void(const RedisClient::Connection::RawKeysList &keylist, const QString &err)>callback) override;
 
+    // Continues paused scan from the same cursor, batches go to callback of loadNamespaceItems()
+    bool loadMoreNamespaceItems(uint dbIndex);
+    bool hasMoreNamespaceItems(uint dbIndex) const;
+
+    // Namespaces with key counts and keys directly under prefix, grouped on the server if luaKeysLoading is enabled.
+    // Only keys matching filter are counted.
+    void loadNamespaceLevel(uint dbIndex, const QByteArray &prefix, const QString &filter, RedisClient::Connection::NamespaceItemsCallback callback);
+
     void disconnect() override;
     void resetConnection() override;
     void duplicateConnection() override;
@@ -75,14 +94,48 @@ signals:
     void filterHistoryUpdated();
 
 protected:
-    void loadDatabases(QSharedPointer<AsyncFuture::Deferred<void>> d, std::function<void(RedisClient::DatabaseList, const QString &)> callback);
+    void loadDatabases(QSharedPointer<AsyncFuture::Deferred<void>> d, QSharedPointer<RedisClient::Connection> connection, std::function<void(RedisClient::DatabaseList, const QString &)> callback);
     void recursiveSelectScan(QSharedPointer<AsyncFuture::Deferred<void>> d, QSharedPointer<RedisClient::Connection> c, QSharedPointer<RedisClient::DatabaseList> dbList, std::function<void(RedisClient::DatabaseList, const QString &)> callback);
     bool connect(QSharedPointer<RedisClient::Connection> c);
+    void updateScanCount(RedisClient::Connection &c);
+    void updateReadRouting(RedisClient::Connection &c);
+    void updateClusterRouting(RedisClient::Connection &c);
+    void closeRoutedConnections();
+    QSharedPointer<RedisClient::Connection> scanConnection();
+    QString updateFilterHistory(const QString &filter);
+    void scanKeys(uint dbIndex, QSharedPointer<RedisClient::Connection> c, const QString &pattern, const QByteArray &type, KeyScanner::BatchCallback callback);
+    KeyScanner::BatchCallback cacheBatches(QSharedPointer<KeyFilterCache::Entry> entry, KeyScanner::BatchCallback callback);
+    KeyScanner::BatchCallback buildNamespaceTree(uint dbIndex, const QString &pattern, QSharedPointer<KeyScanner::BatchCallback> target);
+    KeyScanner::BatchCallback streamKeys(uint dbIndex, KeysCallback callback);
+    void cancelKeyScanners();
+    void groupNamespaceLevel(uint dbIndex, QSharedPointer<RedisClient::Connection> c, const QByteArray &prefix, const QByteArray &pattern, const QByteArray &type, RedisClient::Connection::NamespaceItemsCallback callback);
+    void cancelNamespaceLevel();
 
     void requestBulkOperation(ConnectionsTree::AbstractNamespaceItem &ns, BulkOperations::Manager::Operation op, BulkOperations::AbstractOperation::OperationCallback callback);
 
+private:
+    // Namespace tree of keys loaded by loadNamespaceItems(), complete once scan is finished.
+    // Batches are inserted in worker threads, trie is accessed under lock.
+    struct NamespaceTree {
+        QMutex lock;
+        NamespaceTrie trie;
+        QString pattern;
+        bool complete;
+
+        NamespaceTree(const QByteArray &separator, const QString &pattern) : trie(separator), pattern(pattern), complete(false) {}
+    };
+
 private:
     QSharedPointer<RedisClient::Connection> m_connection;
+    ConnectionPool m_pool;
+    QSharedPointer<ClusterKeysScanner> m_clusterKeysScanner;
+    QHash<uint, QSharedPointer<KeyScanner>> m_keyScanners;
+    QHash<uint, QSharedPointer<NamespaceTree>> m_namespaceTrees;
+    QHash<uint, QSharedPointer<KeyScanner::BatchCallback>> m_keysTargets;
+    KeyFilterCache m_filterCache;
+    QSharedPointer<NamespaceAggregator> m_namespaceAggregator;
+    QSharedPointer<KeyScanner> m_levelScanner;
+    QSharedPointer<ClusterKeysScanner> m_levelClusterScanner;
     QSharedPointer<Events> m_events;
     uint m_dbCount;
     RedisClient::Connection::Mode m_connectionMode;
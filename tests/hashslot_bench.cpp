@@ -0,0 +1,118 @@
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QVector>
+#include <cstdio>
+#include <random>
+#include "command.h"
+#include "app/models/hashslot.h"
+
+
+// HashSlot against a bit-wise CRC16 reference and against
+// Command::calcKeyHashSlot() which uses crc16() of qredisclient, then cost per
+// key of both for a batch of typical key names.
+namespace {
+    const int CHECK_KEYS = 200000;
+    const int BENCH_KEYS = 1000000;
+    const int BENCH_ROUNDS = 5;
+
+    int failures = 0;
+
+    void fail(const char* check, const QByteArray& key) {
+        if (++failures <= 10) {
+            std::printf("FAIL %s: key '%s'\n", check, key.toHex().constData());
+        }
+    }
+
+    // CRC16 XMODEM as described in cluster specification
+    quint16 referenceCrc16(const QByteArray& data) {
+        quint16 crc = 0;
+        for (char c : data) {
+            crc ^= static_cast<quint16>(static_cast<uchar>(c) << 8);
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = static_cast<quint16>(crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1);
+            }
+        }
+        return crc;
+    }
+
+    // Braces are frequent, so keys with empty, unclosed and several hashtags are covered
+    QByteArray randomKey(std::mt19937& random, int maxSize) {
+        static const QByteArray alphabet("abcxyz:{}\x00\xff", 11);
+        int size = std::uniform_int_distribution<int>(0, maxSize)(random);
+        QByteArray key(size, ' ');
+        for (int i = 0; i < size; ++i) {
+            key[i] = alphabet.at(std::uniform_int_distribution<int>(0, alphabet.size() - 1)(random));
+        }
+        return key;
+    }
+
+    // user:{1234567}:session:8f3a... - hashtag and a tail longer than 8 bytes
+    QByteArray typicalKey(std::mt19937& random) {
+        quint32 id = random();
+        return "user:{" + QByteArray::number(id % 10000000) + "}:session:" + QByteArray::number(random(), 16);
+    }
+
+    double nsPerKey(qint64 nsecs, int keys) {
+        return double(nsecs) / keys;
+    }
+}
+
+int main() {
+    if (referenceCrc16("123456789") != 0x31C3 || HashSlot::crc16("123456789", 9) != 0x31C3) {
+        fail("crc16 check value", "123456789");
+    }
+
+    std::mt19937 random(16384);
+    RedisClient::Connection::RawKeysList keys;
+    for (int i = 0; i < CHECK_KEYS; ++i) {
+        keys.append(randomKey(random, 70));
+    }
+
+    QVector<quint16> slots = HashSlot::keySlots(keys);
+    for (int i = 0; i < keys.size(); ++i) {
+        const QByteArray& key = keys.at(i);
+        if (HashSlot::crc16(key.constData(), key.size()) != referenceCrc16(key)) {
+            fail("crc16", key);
+        }
+        if (slots.at(i) != RedisClient::Command::calcKeyHashSlot(key)) {
+            fail("keySlots", key);
+        }
+    }
+
+    RedisClient::Connection::RawKeysList benchKeys;
+    for (int i = 0; i < BENCH_KEYS; ++i) {
+        benchKeys.append(typicalKey(random));
+    }
+
+    QElapsedTimer timer;
+    qulonglong checksum = 0;
+    qint64 commandNs = 0;
+    qint64 batchNs = 0;
+
+    for (int round = 0; round < BENCH_ROUNDS; ++round) {
+        timer.start();
+        for (const QByteArray& key : benchKeys) {
+            checksum += RedisClient::Command::calcKeyHashSlot(key);
+        }
+        commandNs += timer.nsecsElapsed();
+
+        timer.restart();
+        QVector<quint16> batch = HashSlot::keySlots(benchKeys);
+        batchNs += timer.nsecsElapsed();
+        for (quint16 slot : batch) { checksum -= slot; }
+    }
+
+    if (checksum != 0) {
+        fail("benchmark slots", QByteArray());
+    }
+
+    std::printf("%-28s %8.1f ns/key\n", "Command::calcKeyHashSlot", nsPerKey(commandNs, BENCH_KEYS * BENCH_ROUNDS));
+    std::printf("%-28s %8.1f ns/key\n", "HashSlot::keySlots", nsPerKey(batchNs, BENCH_KEYS * BENCH_ROUNDS));
+
+    if (failures > 0) {
+        std::printf("%d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("hash slots match reference\n");
+    return 0;
+}
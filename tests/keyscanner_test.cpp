@@ -0,0 +1,73 @@
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QList>
+#include <QString>
+#include <cstdio>
+#include "connection.h"
+#include "app/models/keyscanner.h"
+
+
+// Keys filter with "type:<name>" token is split into SCAN pattern and TYPE,
+// and KeyScanner sends TYPE to the server. Commands are recorded by a fake
+// connection instead of being sent.
+namespace {
+    int failures = 0;
+
+    void fail(const char* check, const QByteArray& details) {
+        std::printf("FAIL %s: %s\n", check, details.constData());
+        failures++;
+    }
+
+    class RecordingConnection : public RedisClient::Connection {
+    public:
+        RecordingConnection() : RedisClient::Connection(RedisClient::ConnectionConfig(), false) {}
+
+        QFuture<RedisClient::Response> runCommand(const RedisClient::Command& cmd) override {
+            commands.append(cmd.getSplitedRepresentattion());
+            return QFuture<RedisClient::Response>();
+        }
+
+        QList<QList<QByteArray>> commands;
+    };
+
+    void checkFilter(const QString& filter, const QString& pattern, const QByteArray& type) {
+        QString actualPattern = filter;
+        QByteArray actualType = KeyScanner::takeTypeFilter(actualPattern);
+        if (actualPattern != pattern || actualType != type) {
+            fail("takeTypeFilter", filter.toUtf8() + " -> '" + actualPattern.toUtf8() + "' '" + actualType + "'");
+        }
+    }
+
+    void checkScan(const QByteArray& type, const QList<QByteArray>& expected) {
+        auto connection = QSharedPointer<RecordingConnection>(new RecordingConnection());
+        KeyScanner scanner(connection, "user:*", 0, 100);
+        scanner.setTypeFilter(type);
+        scanner.start([](const RedisClient::Connection::RawKeysList&, const QString&, bool) {});
+
+        if (connection->commands.size() != 1 || connection->commands.first() != expected) {
+            QByteArray sent;
+            for (const auto& cmd : connection->commands) { sent += "[" + cmd.join(' ') + "]"; }
+            fail("scan command", sent);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    checkFilter("user:*", "user:*", QByteArray());
+    checkFilter("type:hash user:*", "user:*", "hash");
+    checkFilter("TYPE:ZSet  user:*", "user:*", "zset");
+    checkFilter("type:stream", QString(), "stream");
+    checkFilter("type:foo*", "type:foo*", QByteArray());
+
+    checkScan(QByteArray(), {"SCAN", "0", "MATCH", "user:*", "COUNT", "100"});
+    checkScan("hash", {"SCAN", "0", "MATCH", "user:*", "COUNT", "100", "TYPE", "hash"});
+
+    if (failures > 0) {
+        std::printf("%d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("key scanner sends TYPE filter\n");
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <QByteArray>
+#include <QVector>
+#include <cstdio>
+#include <random>
+#include "app/models/namespacesplitter.h"
+#include "app/models/namespacetrie.h"
+
+
+// Randomized equivalence of NamespaceSplitter with a naive reference:
+// separator positions of the SIMD search, a batch which is split across the
+// thread pool, and trie built from split results.
+namespace {
+    const int ROUNDS = 20000;
+    const int BATCH_SIZE = 3 * NamespaceSplitter::MIN_KEYS_PER_TASK + 17;
+
+    int failures = 0;
+
+    void fail(const char* check, const QByteArray& key, const QByteArray& separator) {
+        if (++failures <= 10) {
+            std::printf("FAIL %s: key '%s' separator '%s'\n", check, key.constData(), separator.constData());
+        }
+    }
+
+    QVector<int> referenceSeparators(const QByteArray& key, const QByteArray& separator) {
+        QVector<int> positions;
+        for (int pos = key.indexOf(separator); pos != -1; pos = key.indexOf(separator, pos + separator.size())) {
+            positions.append(pos);
+        }
+        return positions;
+    }
+
+    // Keys up to 80 bytes cross several 16 byte blocks, small alphabet makes separators frequent
+    QByteArray randomKey(std::mt19937& random, const QByteArray& alphabet) {
+        int size = std::uniform_int_distribution<int>(0, 80)(random);
+        QByteArray key(size, ' ');
+        for (int i = 0; i < size; ++i) {
+            key[i] = alphabet.at(std::uniform_int_distribution<int>(0, alphabet.size() - 1)(random));
+        }
+        return key;
+    }
+
+    void checkSeparators(std::mt19937& random, const QByteArray& separator) {
+        for (int round = 0; round < ROUNDS; ++round) {
+            QByteArray key = randomKey(random, QByteArray("ab:/") + separator);
+            QVector<int> positions;
+            NamespaceSplitter::findSeparators(key.constData(), key.size(), separator, positions);
+
+            if (positions != referenceSeparators(key, separator)) {
+                fail("findSeparators", key, separator);
+            }
+        }
+    }
+
+    void checkBatch(std::mt19937& random, const QByteArray& separator) {
+        RedisClient::Connection::RawKeysList keys;
+        for (int i = 0; i < BATCH_SIZE; ++i) {
+            keys.append(randomKey(random, QByteArray("abc") + separator));
+        }
+
+        NamespaceSplitter::Result result = NamespaceSplitter::split(keys, separator);
+        if (result.keysCount() != keys.size()) {
+            return fail("keysCount", QByteArray(), separator);
+        }
+
+        for (int k = 0; k < keys.size(); ++k) {
+            QVector<int> expected = referenceSeparators(keys.at(k), separator);
+            QVector<int> actual(result.separators(k), result.separators(k) + result.separatorsCount(k));
+            if (actual != expected) {
+                fail("split", keys.at(k), separator);
+            }
+        }
+
+        NamespaceTrie fromSplit(separator);
+        fromSplit.insert(keys, result);
+        NamespaceTrie reference(separator);
+        reference.insert(keys);
+
+        if (fromSplit.nodesCount() != reference.nodesCount() || fromSplit.keysCount() != reference.keysCount()
+                || fromSplit.items() != reference.items()) {
+            fail("trie", QByteArray(), separator);
+        }
+    }
+}
+
+int main() {
+    std::mt19937 random(20240501);
+
+    for (const QByteArray& separator : {QByteArray(":"), QByteArray("::"), QByteArray("/"), QByteArray(":a:"), QByteArray("aa")}) {
+        checkSeparators(random, separator);
+        checkBatch(random, separator);
+    }
+
+    if (failures > 0) {
+        std::printf("%d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("namespace splitter matches reference\n");
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QList>
+#include <QVector>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include "app/models/key-models/rowcache.h"
+
+
+// Lookup cost of MappedCache for sequential access (view reads page cell by
+// cell) and random access (jumps across a large collection).
+namespace {
+    const RowIndex PAGE_SIZE = 100;
+    const RowIndex PAGES = 50000;
+    const int LOOKUPS = 5000000;
+
+    void report(const char* name, qint64 nsecs, int lookups) {
+        std::printf("%-12s %8.1f ns/lookup\n", name, double(nsecs) / lookups);
+    }
+}
+
+int main() {
+    RowCacheBudget::setLimits(std::numeric_limits<qulonglong>::max(), std::numeric_limits<qulonglong>::max());
+
+    MappedCache<QByteArray> cache;
+    for (RowIndex page = 0; page < PAGES; ++page) {
+        QList<QByteArray> rows;
+        for (RowIndex row = page * PAGE_SIZE; row < (page + 1) * PAGE_SIZE; ++row) {
+            rows.append(QByteArray::number(row));
+        }
+        cache.addLoadedRange({page * PAGE_SIZE, (page + 1) * PAGE_SIZE - 1}, rows);
+    }
+
+    const RowIndex rowsCount = PAGES * PAGE_SIZE;
+    qulonglong checksum = 0;
+    QElapsedTimer timer;
+
+    // NOTE: getData() checks isRowLoaded() before reading row, so both are measured
+    timer.start();
+    for (int i = 0; i < LOOKUPS; ++i) {
+        RowIndex row = i % rowsCount;
+        if (cache.isRowLoaded(row)) { checksum += cache[row].size(); }
+    }
+    report("sequential", timer.nsecsElapsed(), LOOKUPS);
+
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<RowIndex> distribution(0, rowsCount - 1);
+    QVector<RowIndex> randomRows(LOOKUPS);
+    for (RowIndex& row : randomRows) { row = distribution(random); }
+
+    timer.restart();
+    for (RowIndex row : randomRows) {
+        if (cache.isRowLoaded(row)) { checksum += cache[row].size(); }
+    }
+    report("random", timer.nsecsElapsed(), LOOKUPS);
+
+    for (int i = 0; i < 1000; ++i) {
+        RowIndex row = randomRows.at(i);
+        if (cache[row] != QByteArray::number(row)) {
+            std::fprintf(stderr, "row %lld: unexpected value %s\n", row, cache[row].constData());
+            return 1;
+        }
+    }
+    if (cache.isRowLoaded(rowsCount)) {
+        std::fprintf(stderr, "row %lld is reported as loaded\n", rowsCount);
+        return 1;
+    }
+
+    std::printf("checksum %llu\n", checksum);
+    return 0;
+}